@@ -0,0 +1,418 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Micro-benchmark of the buffering engine on the shipped test designs.
+// Times the Steiner tree construction, the bottom-up candidate generation,
+// candidate pruning, the top-down insertion and the parasitics update of
+// every signal net and reports per-stage percentiles as JSON.
+
+#include <tcl.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OpenPhySyn/Database/DatabaseHandler.hpp"
+#include "OpenPhySyn/Optimize/BufferTree.hpp"
+#include "OpenPhySyn/Optimize/SteinerTree.hpp"
+#include "OpenPhySyn/Utils/PsnGlobal.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "PsnLogger/PsnLogger.hpp"
+#include "Utils/FileUtils.hpp"
+#include "cxxopts.hpp"
+
+#ifndef PSN_BENCH_DATA_DIR
+#define PSN_BENCH_DATA_DIR "../tests/data"
+#endif
+
+using namespace psn;
+
+namespace
+{
+
+// Benchmarked design and its clock definition
+struct BenchDesign
+{
+    std::string name;
+    std::string def_path;   // Relative to the designs directory
+    std::string clock_port; // Clock source port
+    float       clock_period;
+};
+
+const std::vector<BenchDesign> bench_designs = {
+    {"aes", "aes/aes.def", "clk", 5E-09},
+    {"gcd", "gcd/gcd.def", "clk", 10E-09},
+    {"swerv", "swerv/swerv.def", "clk", 10E-09},
+    {"timing_buffer", "timing_buffer/gcd_gp.def", "clk", 10E-09},
+};
+
+const std::vector<std::string> bench_stages = {
+    "steiner_tree", "bottom_up", "prune", "top_down", "parasitics"};
+
+// Samples of one measured quantity
+class BenchSamples
+{
+public:
+    void
+    add(double value)
+    {
+        values_.push_back(value);
+    }
+    void
+    write(std::ostream& out, const std::string& indent)
+    {
+        std::sort(values_.begin(), values_.end());
+        double total = 0.0;
+        for (auto& value : values_)
+        {
+            total += value;
+        }
+        out << "{\n";
+        out << indent << "  \"count\": " << values_.size() << ",\n";
+        out << indent << "  \"total\": " << total << ",\n";
+        out << indent << "  \"mean\": "
+            << (values_.size() ? total / values_.size() : 0.0) << ",\n";
+        out << indent << "  \"p50\": " << percentile(0.50) << ",\n";
+        out << indent << "  \"p90\": " << percentile(0.90) << ",\n";
+        out << indent << "  \"p99\": " << percentile(0.99) << ",\n";
+        out << indent << "  \"max\": "
+            << (values_.size() ? values_.back() : 0.0) << "\n";
+        out << indent << "}";
+    }
+
+private:
+    // Nearest-rank percentile of the sorted samples
+    double
+    percentile(double fraction) const
+    {
+        if (values_.empty())
+        {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(fraction * values_.size());
+        return values_[std::min(rank, values_.size() - 1)];
+    }
+    std::vector<double> values_;
+};
+
+// Measurements of one design
+struct BenchResult
+{
+    std::string                         name;
+    bool                                loaded;
+    size_t                              nets;
+    size_t                              skipped_nets;
+    size_t                              inserted_buffers;
+    std::map<std::string, BenchSamples> stages; // Microseconds per net
+    BenchSamples                        root_candidates;
+    BenchSamples                        evaluated_candidates;
+};
+
+double
+elapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int
+loadDesign(Psn& psn_inst, const std::string& data_dir,
+           const BenchDesign& design, const std::string& layer)
+{
+    auto def_path = FileUtils::joinPath(
+        FileUtils::joinPath(data_dir, "designs"), design.def_path);
+    if (!FileUtils::pathExists(def_path))
+    {
+        PSN_LOG_WARN("Skipping {}: {} not found", design.name, def_path);
+        return -1;
+    }
+    psn_inst.clearDatabase();
+    psn_inst.readLib(
+        FileUtils::joinPath(data_dir, "libraries/Nangate45/"
+                                      "NangateOpenCellLibrary_typical.lib")
+            .c_str());
+    psn_inst.readLef(
+        FileUtils::joinPath(data_dir, "libraries/Nangate45/"
+                                      "NangateOpenCellLibrary.mod.lef")
+            .c_str());
+    if (psn_inst.readDef(def_path.c_str()) < 0)
+    {
+        return -1;
+    }
+    // Returns 1 on success
+    if (psn_inst.setWireRC(layer.c_str()) < 0)
+    {
+        PSN_LOG_WARN("Skipping {}: no wire RC for layer {}", design.name,
+                     layer);
+        return -1;
+    }
+    psn_inst.handler()->createClock("core_clock", {design.clock_port},
+                                    design.clock_period);
+    return 0;
+}
+
+void
+benchDesign(Psn& psn_inst, BenchResult& result, bool apply)
+{
+    DatabaseHandler& handler = *(psn_inst.handler());
+
+    std::unique_ptr<OptimizationOptions> options(new OptimizationOptions());
+    auto buffer_libs      = handler.bufferClusters(PSN_CLUSTER_SIZE_SMALL);
+    options->buffer_lib   = buffer_libs.first;
+    options->inverter_lib = buffer_libs.second;
+    options->buffer_lib_set = std::unordered_set<LibraryCell*>(
+        options->buffer_lib.begin(), options->buffer_lib.end());
+    options->inverter_lib_set = std::unordered_set<LibraryCell*>(
+        options->inverter_lib.begin(), options->inverter_lib.end());
+    std::sort(options->buffer_lib.begin(), options->buffer_lib.end(),
+              [&handler](LibraryCell* a, LibraryCell* b) -> bool {
+                  return handler.area(a) < handler.area(b);
+              });
+    std::sort(options->inverter_lib.begin(), options->inverter_lib.end(),
+              [&handler](LibraryCell* a, LibraryCell* b) -> bool {
+                  return handler.area(a) < handler.area(b);
+              });
+    if (options->buffer_lib.empty())
+    {
+        PSN_LOG_WARN("No buffer cells found for {}", result.name);
+        return;
+    }
+    auto upstream_res_cell =
+        options->buffer_lib[options->buffer_lib.size() / 2];
+
+    float area       = handler.area();
+    int   net_index  = 0;
+    int   buff_index = 0;
+    auto  clock_nets = handler.clockNets();
+    auto  nets       = handler.nets(); // Nets added by top-down are skipped
+
+    for (auto& net : nets)
+    {
+        if (clock_nets.count(net) || handler.isSpecial(net))
+        {
+            result.skipped_nets++;
+            continue;
+        }
+        auto start   = std::chrono::steady_clock::now();
+        auto st_tree = SteinerTree::create(net, &psn_inst);
+        auto st_time = elapsedMicroseconds(start);
+        if (!st_tree)
+        {
+            result.skipped_nets++;
+            continue;
+        }
+        auto driver_point = st_tree->driverPoint();
+        auto driver_pin   = st_tree->pin(driver_point);
+        if (!driver_pin || handler.isTopLevel(driver_pin))
+        {
+            result.skipped_nets++;
+            continue;
+        }
+        result.nets++;
+        result.stages["steiner_tree"].add(st_time);
+
+        auto top_point = st_tree->top();
+        start          = std::chrono::steady_clock::now();
+        auto buff_sol  = BufferSolution::bottomUp(
+            &psn_inst, driver_pin, top_point, driver_point, std::move(st_tree),
+            options);
+        result.stages["bottom_up"].add(elapsedMicroseconds(start));
+        result.root_candidates.add(buff_sol->trees().size());
+        result.evaluated_candidates.add(
+            buff_sol->boundStats().evaluated_candidates);
+
+        // Pruning already ran inside bottom-up, this measures a pass over
+        // the final candidate set of the driver
+        start = std::chrono::steady_clock::now();
+        buff_sol->prune(&psn_inst, upstream_res_cell,
+                        options->minimum_upstream_resistance);
+        result.stages["prune"].add(elapsedMicroseconds(start));
+
+        if (!apply || buff_sol->trees().empty())
+        {
+            continue;
+        }
+        std::shared_ptr<BufferTree> inverted_tree;
+        auto                        buff_tree = buff_sol->optimalDriverTree(
+            &psn_inst, driver_pin, inverted_tree);
+        if (!buff_tree)
+        {
+            continue;
+        }
+        std::unordered_set<Instance*> added_buffers;
+        std::unordered_set<Net*>      affected_nets;
+        start = std::chrono::steady_clock::now();
+        BufferSolution::topDown(&psn_inst, driver_pin, buff_tree, area,
+                                net_index, buff_index, added_buffers,
+                                affected_nets);
+        result.stages["top_down"].add(elapsedMicroseconds(start));
+        result.inserted_buffers += added_buffers.size();
+
+        start = std::chrono::steady_clock::now();
+        for (auto& affected_net : affected_nets)
+        {
+            handler.calculateParasitics(affected_net);
+        }
+        result.stages["parasitics"].add(elapsedMicroseconds(start));
+    }
+}
+
+void
+writeResults(std::ostream& out, std::vector<BenchResult>& results)
+{
+    out << "{\n  \"unit\": \"us\",\n  \"designs\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        auto& result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": \"" << result.name << "\",\n";
+        out << "      \"loaded\": " << (result.loaded ? "true" : "false")
+            << ",\n";
+        out << "      \"nets\": " << result.nets << ",\n";
+        out << "      \"skipped_nets\": " << result.skipped_nets << ",\n";
+        out << "      \"inserted_buffers\": " << result.inserted_buffers
+            << ",\n";
+        out << "      \"stages\": {";
+        for (size_t j = 0; j < bench_stages.size(); j++)
+        {
+            out << (j ? ",\n" : "\n") << "        \"" << bench_stages[j]
+                << "\": ";
+            result.stages[bench_stages[j]].write(out, "        ");
+        }
+        out << "\n      },\n";
+        out << "      \"root_candidates\": ";
+        result.root_candidates.write(out, "      ");
+        out << ",\n      \"evaluated_candidates\": ";
+        result.evaluated_candidates.write(out, "      ");
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    std::string              data_dir = PSN_BENCH_DATA_DIR;
+    std::string              layer    = "metal2";
+    std::string              output_path;
+    std::vector<std::string> design_names;
+    bool                     apply = true;
+    try
+    {
+        cxxopts::Options options(
+            "psn_bench", "OpenPhySyn buffering engine micro-benchmark.");
+        options.add_options()("h,help", "Display this help message and exit")(
+            "d,design", "Benchmark only the given designs",
+            cxxopts::value<std::vector<std::string>>(design_names))(
+            "data", "Test data directory",
+            cxxopts::value<std::string>(data_dir))(
+            "layer", "Wire RC layer", cxxopts::value<std::string>(layer))(
+            "o,output", "Write the JSON report to a file instead of stdout",
+            cxxopts::value<std::string>(output_path))(
+            "no-apply", "Skip the top-down insertion and parasitics stages");
+        auto result = options.parse(argc, argv);
+        if (result.count("help"))
+        {
+            std::cout << options.help() << std::endl;
+            return 0;
+        }
+        apply = !result.count("no-apply");
+    }
+    catch (cxxopts::OptionException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+
+    Psn::initialize();
+    Tcl_Interp* interp = Tcl_CreateInterp();
+    Tcl_Init(interp);
+    Psn& psn_inst = Psn::instance();
+    if (psn_inst.setupInterpreter(interp, true, false, true) != TCL_OK)
+    {
+        PSN_LOG_ERROR("Failed to initialize Tcl interpreter.");
+        return -1;
+    }
+
+    std::vector<BenchResult> results;
+    for (auto& design : bench_designs)
+    {
+        if (design_names.size() &&
+            std::find(design_names.begin(), design_names.end(),
+                      design.name) == design_names.end())
+        {
+            continue;
+        }
+        BenchResult result;
+        result.name             = design.name;
+        result.nets             = 0;
+        result.skipped_nets     = 0;
+        result.inserted_buffers = 0;
+        try
+        {
+            result.loaded = loadDesign(psn_inst, data_dir, design, layer) == 0;
+            if (result.loaded)
+            {
+                PSN_LOG_INFO("Benchmarking {}", design.name);
+                benchDesign(psn_inst, result, apply);
+            }
+        }
+        catch (PsnException& e)
+        {
+            PSN_LOG_ERROR("{}: {}", design.name, e.what());
+            result.loaded = false;
+        }
+        results.push_back(std::move(result));
+    }
+
+    if (output_path.size())
+    {
+        std::ofstream out(output_path);
+        if (!out)
+        {
+            PSN_LOG_ERROR("Failed to open {}", output_path);
+            return -1;
+        }
+        writeResults(out, results);
+    }
+    else
+    {
+        writeResults(std::cout, results);
+    }
+    return 0;
+}
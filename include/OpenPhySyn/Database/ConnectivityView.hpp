@@ -0,0 +1,145 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "OpenPhySyn/Database/Types.hpp"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace sta
+{
+class Network;
+} // namespace sta
+
+namespace psn
+{
+
+// Contiguous read-only range of pins inside a ConnectivityView
+class PinSpan
+{
+public:
+    PinSpan(InstanceTerm* const* begin, InstanceTerm* const* end);
+
+    InstanceTerm* const* begin() const;
+    InstanceTerm* const* end() const;
+    size_t               size() const;
+    bool                 empty() const;
+    InstanceTerm*        operator[](size_t index) const;
+
+private:
+    InstanceTerm* const* begin_;
+    InstanceTerm* const* end_;
+};
+
+// ConnectivityView is a compressed-sparse-row copy of the flat netlist. Nets,
+// instances and pins get dense ids, every net row holds all its pins followed
+// by its instance input pins and the top-level output ports it drives, and
+// every instance row holds its pins followed by its inputs and its outputs.
+//
+// Edits are recorded with addNet, addInstance, invalidate and remove; the
+// affected rows are re-gathered from the network by the next refresh and
+// appended to the pin pool, which is compacted once most of it is stale.
+// Ids stay valid until their object is removed. Queries on objects the view
+// does not know return empty results so callers can fall back to the network.
+class ConnectivityView
+{
+public:
+    ConnectivityView();
+
+    void build(sta::Network* network);
+    void clear();
+    bool built() const;
+    // Re-gathers the rows of the edited nets and instances
+    void refresh();
+
+    void addNet(Net* net);
+    void addInstance(Instance* inst);
+    void invalidate(Net* net);
+    void invalidate(Instance* inst);
+    void remove(Net* net);
+    // Also invalidates the nets connected to the instance
+    void remove(Instance* inst);
+
+    int           netId(const Net* net) const;
+    int           instanceId(const Instance* inst) const;
+    int           pinId(const InstanceTerm* pin) const;
+    Net*          net(int net_id) const;
+    Instance*     instance(int inst_id) const;
+    InstanceTerm* pin(int pin_id) const;
+    size_t        netCount() const; // Upper bound of the net ids
+    size_t        instanceCount() const;
+    size_t        pinCount() const;
+
+    // First instance output pin of the net, nullptr if the net is undriven
+    InstanceTerm* driver(const Net* net) const;
+    int           driverId(int net_id) const;
+    PinSpan       pins(const Net* net) const;
+    PinSpan       pins(int net_id) const;
+    // Instance input pins of the net, followed by the top-level output ports
+    // when include_top_level is set
+    PinSpan fanoutPins(const Net* net, bool include_top_level = false) const;
+    PinSpan fanoutPins(int net_id, bool include_top_level = false) const;
+
+    PinSpan pins(const Instance* inst) const;
+    PinSpan inputPins(const Instance* inst) const;
+    PinSpan outputPins(const Instance* inst) const;
+
+private:
+    PinSpan rowSpan(const std::vector<size_t>& rows, int id, int first,
+                    int last) const;
+    int     pinIdOrAdd(InstanceTerm* pin);
+    void    gatherNet(int net_id);
+    void    gatherInstance(int inst_id);
+    void    compact();
+
+    sta::Network*              network_;
+    bool                       built_;
+    std::vector<InstanceTerm*> pool_;
+    size_t                     stale_pool_size_; // Pins of replaced rows
+
+    // Rows are four offsets into pool_ per id; removed objects are nullptr
+    std::vector<Net*>                            nets_;
+    std::vector<size_t>                          net_rows_;
+    std::vector<int>                             net_drivers_; // Pin id or -1
+    std::vector<bool>                            net_stale_;
+    std::vector<int>                             stale_nets_;
+    std::unordered_map<const Net*, int>          net_ids_;
+    std::vector<Instance*>                       instances_;
+    std::vector<size_t>                          instance_rows_;
+    std::vector<bool>                            instance_stale_;
+    std::vector<int>                             stale_instances_;
+    std::unordered_map<const Instance*, int>     instance_ids_;
+    std::vector<InstanceTerm*>                   pins_;
+    std::unordered_map<const InstanceTerm*, int> pin_ids_;
+};
+} // namespace psn
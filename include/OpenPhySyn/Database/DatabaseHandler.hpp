@@ -30,12 +30,18 @@
 // POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include "OpenPhySyn/Database/ConnectivityView.hpp"
 #include "OpenPhySyn/Database/Types.hpp"
+#include "OpenPhySyn/Liberty/BufferDelayModel.hpp"
+#include "OpenPhySyn/Liberty/CompiledFunction.hpp"
+#include "OpenPhySyn/Liberty/LibraryCharacterization.hpp"
+#include "OpenPhySyn/Liberty/NldmTable.hpp"
 #include "OpenPhySyn/Sta/PathPoint.hpp"
 
 #include <bitset>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -43,7 +49,9 @@
 #include <vector>
 namespace sta
 {
+class Graph;
 class TimingArc;
+class ArcDelayCalc;
 class RiseFall;
 class ParasiticAnalysisPt;
 class Pvt;
@@ -71,6 +79,10 @@ typedef std::function<void(Net*)>         ComputeParasiticsCallback;
 typedef std::function<float()>            MaxAreaCallback;
 typedef std::function<void(float)>        UpdateDesignAreaCallback;
 
+typedef std::function<void(InstanceTerm*)> PinVisitor;
+typedef std::function<void(Net*)>          NetVisitor;
+typedef std::function<void(Vertex*)>       VertexVisitor;
+
 enum ElectircalViolation
 {
     None,
@@ -99,6 +111,9 @@ public:
                                levelDriverPins(bool                              reverse = false,
                                                std::unordered_set<InstanceTerm*> filter_pins =
                                                    std::unordered_set<InstanceTerm*>()) const;
+    // Rebuilds the levelDriverPins cache from the graph on its next use, for
+    // netlist edits made outside the handler
+    void                       invalidateLevelDrivers();
     std::vector<Instance*>     driverInstances() const;
     InstanceTerm*              faninPin(Net* net) const;
     InstanceTerm*              faninPin(InstanceTerm* term) const;
@@ -110,6 +125,17 @@ public:
     std::vector<InstanceTerm*> connectedPins(Net* net) const;
     std::set<InstanceTerm*>    clockPins() const;
     std::set<Net*>             clockNets() const;
+    // Streaming variants of the queries above, the visitor is called for each
+    // item as it is read instead of collecting the items in a container.
+    void forEachNet(const NetVisitor& visitor) const;
+    void forEachPin(Net* net, const PinVisitor& visitor) const;
+    void forEachPin(Instance* inst, const PinVisitor& visitor) const;
+    void forEachFanoutPin(Net* net, const PinVisitor& visitor,
+                          bool include_top_level = false) const;
+    // Driver vertices of the timing graph, in graph order
+    void forEachDriverVertex(const VertexVisitor& visitor) const;
+    // Nets reached from the clock sources, each visited once
+    void forEachClockNet(const NetVisitor& visitor) const;
     Point                      location(InstanceTerm* term);
     Point                      location(Instance* inst);
     float                      area(LibraryCell* cell) const;
@@ -169,6 +195,9 @@ public:
                     float* tr_slew = nullptr);
     float gateDelay(LibraryTerm* out_port, float load_cap,
                     float* tr_slew = nullptr);
+    // Worst delay of the output port for each load, one table pass per arc
+    void  gateDelays(LibraryTerm* out_port, const std::vector<float>& load_caps,
+                     std::vector<float>& delays, float* tr_slew = nullptr);
     float bufferChainDelayPenalty(float load_cap);
     float inverterInputCapacitance(LibraryCell* buffer_cell);
     float bufferInputCapacitance(LibraryCell* buffer_cell) const;
@@ -179,12 +208,17 @@ public:
     float         largestInputCapacitance(LibraryCell* cell);
     float portCapacitance(const LibraryTerm* port, bool isMax = true) const;
     float bufferDelay(psn::LibraryCell* buffer_cell, float load_cap);
+    float bufferSlew(psn::LibraryCell* buffer_cell, float load_cap,
+                     float input_slew);
+    const BufferDelayModel* bufferDelayModel(LibraryCell* buffer_cell);
     float maxLoad(LibraryTerm* term);
     Net*  net(const char* name) const;
     LibraryTerm* libraryPin(const char* cell_name, const char* pin_name) const;
     LibraryTerm* libraryPin(LibraryCell* cell, const char* pin_name) const;
     LibraryTerm* bufferInputPin(LibraryCell* buffer_cell) const;
     LibraryTerm* bufferOutputPin(LibraryCell* buffer_cell) const;
+    // Drive resistance of the buffer/inverter output pin
+    float driveResistance(LibraryCell* buffer_cell) const;
     std::unordered_set<InstanceTerm*> commutativePins(InstanceTerm* term);
     std::vector<LibraryTerm*>         libraryPins(Instance* inst) const;
     std::vector<LibraryTerm*>         libraryPins(LibraryCell* cell) const;
@@ -225,6 +259,8 @@ public:
     std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>
                               bufferClusters(float cluster_threshold, bool find_superior = true,
                                              bool include_inverting = true);
+    // Not kept in the characterization cache: OpenSTA builds the classes in
+    // one hashing pass over the libraries, cheaper than restoring them.
     std::vector<LibraryCell*> equivalentCells(LibraryCell* cell);
     LibraryCell*              smallestInverterCell() const;
     LibraryCell*              smallestBufferCell() const;
@@ -314,6 +350,11 @@ public:
     float slew(InstanceTerm* term) const;
     float slew(InstanceTerm* term, bool is_rise) const;
     float slew(LibraryTerm* term, float cap, float* tr_slew = nullptr);
+    // Worst output slew for each (load, input slew) pair, one table pass per
+    // arc
+    void  slews(LibraryTerm* term, const std::vector<float>& load_caps,
+                const std::vector<float>& input_slews,
+                std::vector<float>&       output_slews);
     float required(InstanceTerm* term) const;
     float required(InstanceTerm* term, bool is_rise,
                    PathAnalysisPoint* path_ap) const;
@@ -359,11 +400,23 @@ public:
                 std::unordered_map<LibraryTerm*, int>& inputs) const;
     int evaluateFunctionExpression(
         LibraryTerm* term, std::unordered_map<LibraryTerm*, int>& inputs) const;
+    // Output value when the input is fixed to value, -1 if it still depends
+    // on the other inputs
+    int cofactorValue(InstanceTerm* term, LibraryTerm* input,
+                      bool value) const;
     void setWireRC(float res_per_micron, float cap_per_micron,
                    bool reset_delays = true);
     void setWireRC(ParasticsCallback res_per_micron,
                    ParasticsCallback cap_per_micron);
     void setDontUseCallback(DontUseCallback dont_use_callback);
+    // Target loads, buffer delay models, buffer chain penalties, buffer
+    // clusters and library mappings are restored from and saved to path,
+    // keyed by the liberty file contents and the dont-use cells. An empty
+    // path turns the cache off.
+    void setCharacterizationCache(const std::string& path);
+    // Writes the results characterized since the last save in one go; runs
+    // after each transform, on a cache path change and on destruction.
+    void saveCharacterizationCache();
     void setComputeParasiticsCallback(
         ComputeParasiticsCallback compute_parasitics_callback);
 
@@ -371,10 +424,36 @@ public:
     HandlerType handlerType() const;
     void        calculateParasitics();
     void        calculateParasitics(Net* net);
+    // Re-extract only the nets edited or moved since their last extraction
+    void        updateParasitics();
+    // Number of threads building the Steiner trees of full-design
+    // extraction, the parasitics are still committed serially in net order
+    void        setParasiticsThreads(int threads);
+    int         parasiticsThreads() const;
+    // Nets with more pins than the limit use the spanning-tree Steiner
+    // heuristic instead of Flute, 0 disables the limit
+    void        setSteinerFluteDegreeLimit(int limit);
+    int         steinerFluteDegreeLimit() const;
+    // Shared Steiner tree of the net, rebuilt only after the net is edited or
+    // one of its cells is moved
+    std::shared_ptr<const SteinerTree> steinerTree(Net* net);
+    // Cached trees of the nets in input order, the missing ones are built
+    // together on the parasitics threads
+    std::vector<std::shared_ptr<const SteinerTree>>
+    steinerTrees(const std::vector<Net*>& nets);
     void        resetCache();
     void        setLegalizer(Legalizer legalizer);
     bool        legalize(int max_displacement = 0);
     float       bufferFixedInputSlew(LibraryCell* buffer_cell, float cap);
+    void        beginConcurrentQueries(const std::vector<Net*>& nets);
+    void        endConcurrentQueries();
+    bool        inConcurrentQueries() const;
+    // Compressed-sparse-row snapshot of the netlist used by the pin and
+    // fanout queries, kept in sync with the handler's own netlist edits.
+    void buildConnectivity();
+    void clearConnectivity();
+    // Refreshed snapshot, nullptr if it is not built
+    const ConnectivityView* connectivity() const;
 
     DatabaseStaNetwork* network() const;
     DatabaseSta*        sta() const;
@@ -415,6 +494,33 @@ private:
 
     std::unordered_set<LibraryCell*> dont_use_;
 
+    // Attributes of one library cell queried by the sizing and buffering
+    // loops, the buffer fields hold the ports reported by bufferPorts.
+    struct CellAttributes
+    {
+        float        area;
+        float        max_load;
+        float        buffer_input_capacitance;
+        float        drive_resistance;
+        LibraryTerm* buffer_input;
+        LibraryTerm* buffer_output;
+        bool         is_buffer;
+        bool         is_inverter;
+        bool         dont_use; // Without the dont-use callback
+    };
+    // Dense cell ids of all the library cells and their attributes, built
+    // on first use and invalidated by resetCache (called on every library
+    // read) and setDontUse.
+    mutable std::unordered_map<const LibraryCell*, int> cell_ids_;
+    mutable std::vector<CellAttributes>                 cell_attributes_;
+    mutable bool                                        has_cell_attributes_;
+
+    void                  buildCellAttributes() const;
+    const CellAttributes* cellAttributes(const LibraryCell* cell) const;
+    float                 masterArea(LibraryCell* cell) const;
+    float                 outputMaxLoad(LibraryCell* cell) const;
+    bool                  inverterFunction(LibraryCell* cell) const;
+
     std::unordered_map<LibraryCell*, float> buffer_penalty_map_;
     std::unordered_map<LibraryCell*, float> inverting_buffer_penalty_map_;
     std::unordered_set<LibraryCell*>        non_inverting_buffer_;
@@ -437,10 +543,111 @@ private:
 
     std::unordered_map<LibraryCell*, float> target_load_map_;
 
+    // Piecewise-linear delay/slew models of the buffers and inverters, built
+    // with the target loads so the buffering engine avoids full arc queries.
+    std::unordered_map<LibraryCell*, BufferDelayModel> buffer_delay_models_;
+
+    void characterizeBufferModels();
+
+    // Delay and slew tables of one timing arc to a cell output
+    struct NldmArc
+    {
+        int       input_transition; // sta::RiseFall index of the input
+        NldmTable delay;
+        NldmTable slew;
+    };
+    // Compiled tables of the output ports whose arcs all use table models,
+    // other ports go through the delay calculator. Rebuilt after resetCache.
+    std::unordered_map<LibraryTerm*, std::vector<NldmArc>> nldm_arcs_;
+    bool                                                   has_nldm_tables_;
+
+    void                        compileNldmTables();
+    const std::vector<NldmArc>* nldmArcs(LibraryTerm* out_port);
+
+    // Port functions compiled over the input pins of their cell, in
+    // libraryInputPins order. Rebuilt after resetCache.
+    mutable std::unordered_map<LibraryTerm*, CompiledFunction>
+        compiled_functions_;
+
+    // nullptr if the port has no function or it does not compile
+    const CompiledFunction* compiledFunction(LibraryTerm* port) const;
+
+    // Nets whose parasitics are stale after connect, disconnect, setLocation,
+    // replaceInstance or legalization, cleared when they are re-extracted.
+    mutable std::unordered_set<Net*> dirty_nets_;
+    mutable std::unordered_map<Net*, std::shared_ptr<const SteinerTree>>
+                       steiner_trees_; // Invalidated with dirty_nets_
+    mutable std::mutex steiner_trees_mutex_;
+    int                parasitics_threads_;
+    int                steiner_flute_degree_limit_;
+
+    // Build the pi-Elmore parasitics of the net from its Steiner tree
+    void commitParasitics(Net*                                      net,
+                          const std::shared_ptr<const SteinerTree>& tree);
+
+    void markDirty(Net* net) const;
+    void markDirty(Instance* inst) const;
+
+    // Read-only query mode used while building buffer solutions on multiple
+    // threads; required times and wire RC are snapshotted and every thread
+    // uses its own copy of the delay calculator.
+    sta::ArcDelayCalc* arcDelayCalc() const;
+
+    bool                                     concurrent_queries_;
+    size_t                                   concurrent_generation_;
+    float                                    concurrent_res_per_micron_;
+    float                                    concurrent_cap_per_micron_;
+    std::unordered_map<InstanceTerm*, float> concurrent_required_;
+    mutable std::vector<sta::ArcDelayCalc*>  concurrent_delay_calcs_;
+    mutable std::mutex                       concurrent_mutex_;
+
+    mutable ConnectivityView connectivity_;
+
+    // Driver pins in vertex id order and bucketed by level for
+    // levelDriverPins; the handler's netlist edits update the set and mark
+    // the order stale instead of walking the whole graph on every call.
+    mutable std::vector<InstanceTerm*>        level_drivers_;
+    mutable std::vector<InstanceTerm*>        level_order_;
+    mutable std::unordered_set<InstanceTerm*> added_driver_pins_;
+    mutable std::unordered_set<InstanceTerm*> removed_driver_pins_;
+    mutable const sta::Graph*                 level_graph_;
+    mutable bool                              level_drivers_valid_;
+    mutable bool                              level_order_stale_;
+
+    void updateLevelDrivers() const;
+
     // Vertex* vertex(InstanceTerm* term) const;
 
     void computeBuffersDelayPenalty(bool include_inverting = true);
 
+    // Persistent library characterization, see setCharacterizationCache
+    std::string                               characterization_path_;
+    LibraryCharacterization                   characterization_;
+    std::unordered_map<std::string, uint64_t> liberty_hashes_; // Per file
+    bool                                      characterization_dirty_;
+
+    bool        characterizationKey(uint64_t& key);
+    bool        loadCharacterization();
+    std::string characterizedName(LibraryCell* cell) const;
+    std::unordered_map<std::string, LibraryCell*> characterizedCells() const;
+    bool restoreTargetLoads();
+    void storeTargetLoads();
+    bool restoreBufferModels();
+    void storeBufferModels(
+        std::vector<LibraryCharacterization::BufferModel> models);
+    bool restoreBufferClusters(
+        float cluster_threshold, bool find_superior, bool include_inverting,
+        std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>&
+            clusters);
+    void storeBufferClusters(
+        float cluster_threshold, bool find_superior, bool include_inverting,
+        const std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>&
+            clusters);
+    bool restoreBufferPenalties(bool include_inverting);
+    void storeBufferPenalties(bool include_inverting);
+    bool restoreLibraryMappings(int max_length);
+    void storeLibraryMappings(int max_length);
+
     /* The following code is borrowed from James Cherry's Resizer Code */
     const sta::Corner*              corner_;
     const sta::DcalcAnalysisPt*     dcalc_ap_;
@@ -471,11 +678,10 @@ private:
     void  findBufferTargetSlews(Liberty* library, float slews[], int counts[]);
     void  slewLimit(InstanceTerm* pin, sta::MinMax* min_max, float& limit,
                     bool& exists) const;
-    sta::ParasiticNode* findParasiticNode(std::unique_ptr<SteinerTree>& tree,
-                                          sta::Parasitic*     parasitic,
-                                          const Net*          net,
-                                          const InstanceTerm* pin,
-                                          SteinerPoint        pt);
+    sta::ParasiticNode*
+    findParasiticNode(const std::shared_ptr<const SteinerTree>& tree,
+                      sta::Parasitic* parasitic, const Net* net,
+                      const InstanceTerm* pin, SteinerPoint pt);
     Legalizer           legalizer_;
     ParasticsCallback   res_per_micron_callback_;
     ParasticsCallback   cap_per_micron_callback_;
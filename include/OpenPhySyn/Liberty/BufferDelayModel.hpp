@@ -0,0 +1,72 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace psn
+{
+
+// BufferDelayModel is a piecewise-linear fit of a buffer or inverter delay
+// and output slew against its load capacitance. The load axis is uniformly
+// sampled so that each evaluation is a single table lookup; loads outside the
+// characterized range are extrapolated from the closest segment.
+class BufferDelayModel
+{
+public:
+    BufferDelayModel();
+    // delays: Delay at the target input slew for each load step.
+    // slews: Output slew for each (input slew step, load step), row-major.
+    BufferDelayModel(float max_load, std::vector<float> delays,
+                     float max_input_slew, size_t input_slew_steps,
+                     std::vector<float> slews);
+
+    float  delay(float load_cap) const;
+    float  slew(float load_cap, float input_slew) const;
+    bool   hasSlew(float input_slew) const;
+    bool   valid() const;
+    float  maxLoad() const;
+    float  maxInputSlew() const;
+    size_t loadSteps() const;
+    size_t inputSlewSteps() const;
+
+private:
+    float interpolate(const float* table, float load_cap) const;
+
+    float              load_step_;       // Load between two breakpoints
+    float              input_slew_step_; // Input slew between two rows
+    size_t             load_steps_;
+    size_t             input_slew_steps_;
+    std::vector<float> delays_;
+    std::vector<float> slews_;
+};
+} // namespace psn
@@ -0,0 +1,113 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "OpenPhySyn/Database/Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sta
+{
+class FuncExpr;
+} // namespace sta
+
+namespace psn
+{
+
+// CompiledFunction is a liberty port function lowered to a flat postfix
+// program over 64-bit words. Every bit lane of a word is an independent
+// input assignment, so the whole truth table of a function of up to six
+// variables is one pass over the program and wider functions take
+// 2^(n - 6) passes.
+class CompiledFunction
+{
+public:
+    CompiledFunction();
+    // variables: Ports bound to the function variables, in variable order.
+    CompiledFunction(const sta::FuncExpr*             func,
+                     const std::vector<LibraryTerm*>& variables);
+
+    // False if the function reads a port outside the variables or uses an
+    // operator other than not, and, or, xor and the constants.
+    bool         valid() const;
+    size_t       variableCount() const;
+    LibraryTerm* variable(size_t index) const;
+    // -1 if the port is not a variable
+    int variableIndex(const LibraryTerm* port) const;
+    // Whether the function expression refers to the variable
+    bool dependsOn(size_t variable) const;
+
+    // Bit k of values[i] is the value of variable i in assignment k, bit k of
+    // the result is the function value for that assignment.
+    uint64_t evaluate(const uint64_t* values) const;
+    // Bit m % 64 of word m / 64 is the function value of minterm m, where
+    // variable i is (m >> i) & 1.
+    std::vector<uint64_t> truthTable() const;
+    // Whether exchanging the two variables leaves the function unchanged
+    bool symmetric(size_t first, size_t second) const;
+    // The function value when fixing the variable to value makes it
+    // constant, -1 otherwise.
+    int constantCofactor(size_t variable, bool value) const;
+
+private:
+    enum Opcode : uint8_t
+    {
+        Variable,
+        Zero,
+        One,
+        Not,
+        And,
+        Or,
+        Xor
+    };
+    struct Instruction
+    {
+        Opcode   opcode;
+        uint32_t variable;
+    };
+
+    void compile(const sta::FuncExpr* func, size_t& depth);
+    // Projection words of the variables for word index of the truth table
+    void   assignmentWords(size_t word, uint64_t* values) const;
+    size_t wordCount() const;
+    // Lanes of a word that hold minterms when there are fewer than six
+    // variables
+    uint64_t laneMask() const;
+
+    std::vector<Instruction>  program_;
+    std::vector<LibraryTerm*> variables_;
+    std::vector<bool>         used_;
+    size_t                    stack_size_;
+    bool                      valid_;
+};
+} // namespace psn
@@ -0,0 +1,129 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace psn
+{
+
+// LibraryCharacterization holds the design-independent results that the
+// database handler derives from the loaded libraries, so they can be saved
+// to a binary file and restored by later runs instead of recomputed. Cells
+// are referenced by "<library>/<cell>" names. The key identifies the
+// libraries and dont-use cells the results were computed for; a file written
+// for another key is ignored.
+class LibraryCharacterization
+{
+public:
+    // A LibraryCellMappingNode and its subtree
+    struct MappingNode
+    {
+        std::string              name;
+        std::string              id;
+        bool                     terminal;
+        bool                     recurring;
+        bool                     is_buffer;
+        bool                     is_inverter;
+        int                      level;
+        std::vector<MappingNode> children;
+    };
+    struct Mapping
+    {
+        std::string              id;
+        std::vector<MappingNode> roots;
+    };
+    // The inputs of a BufferDelayModel
+    struct BufferModel
+    {
+        std::string        cell;
+        float              max_load;
+        float              max_input_slew;
+        uint32_t           input_slew_steps;
+        std::vector<float> delays;
+        std::vector<float> slews;
+    };
+
+    LibraryCharacterization();
+
+    // 64-bit FNV-1a of the bytes, continued from seed
+    static uint64_t hash(const void* data, size_t size,
+                         uint64_t seed = 0xcbf29ce484222325ULL);
+    // Hash of the file contents continued from hash, false if the file
+    // cannot be read.
+    static bool hashFile(const std::string& path, uint64_t& hash);
+
+    // False if the file is missing, malformed or written for another key;
+    // the current results are left unchanged in that case.
+    bool read(const std::string& path, uint64_t expected_key);
+    // Writes to a temporary file first and renames it, so concurrent runs
+    // never read a partial file.
+    bool write(const std::string& path) const;
+    void clear();
+
+    uint64_t key;
+
+    // findTargetLoads
+    bool                                       has_target_loads;
+    float                                      target_slews[2];
+    std::vector<std::pair<std::string, float>> target_loads;
+
+    // characterizeBufferModels
+    bool                     has_buffer_models;
+    std::vector<BufferModel> buffer_models;
+
+    // computeBuffersDelayPenalty
+    bool                                       has_buffer_penalties;
+    bool                                       include_inverting;
+    std::vector<std::string>                   buffer_sequence;
+    std::vector<std::string>                   inverting_buffers;
+    std::vector<std::pair<std::string, float>> buffer_penalties;
+    std::vector<std::pair<std::string, float>> inverting_penalties;
+
+    // buildLibraryMappings
+    bool                                             has_library_mappings;
+    int                                              mapping_length;
+    std::vector<std::pair<std::string, std::string>> truth_tables;
+    std::vector<Mapping>                             mappings;
+
+    // bufferClusters, for the last arguments only
+    bool                     has_buffer_clusters;
+    float                    cluster_threshold;
+    bool                     find_superior;
+    bool                     cluster_inverting;
+    std::vector<std::string> cluster_buffers;
+    std::vector<std::string> cluster_inverters;
+};
+} // namespace psn
@@ -0,0 +1,76 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace psn
+{
+
+// NldmTable is a flat copy of a liberty delay or slew table indexed by input
+// slew and load capacitance, with the library scaling already applied.
+// Lookups interpolate bilinearly and extrapolate linearly from the closest
+// segment outside the axes, as OpenSTA does. An axis with a single
+// breakpoint makes the table constant along that axis.
+class NldmTable
+{
+public:
+    NldmTable();
+    // values: One row of load_axis.size() values per input slew breakpoint.
+    NldmTable(std::vector<float> slew_axis, std::vector<float> load_axis,
+              std::vector<float> values);
+
+    float lookup(float input_slew, float load_cap) const;
+    // Evaluates count (input slew, load) points in one call. The points are
+    // processed in blocks: the segments of the whole block are located
+    // first, then the block is interpolated in a branch-free loop that the
+    // compiler can vectorize.
+    void lookup(const float* input_slews, const float* load_caps,
+                float* results, size_t count) const;
+    bool valid() const;
+
+private:
+    static void segment(const std::vector<float>& axis,
+                        const std::vector<float>& inverse_steps, float value,
+                        size_t& index, float& frac);
+    static void segments(const std::vector<float>& axis,
+                         const std::vector<float>& inverse_steps,
+                         const float* values, size_t count, size_t* indices,
+                         float* fracs);
+
+    std::vector<float> slew_axis_;
+    std::vector<float> load_axis_;
+    std::vector<float> slew_inverse_steps_; // 1 / (axis[i + 1] - axis[i])
+    std::vector<float> load_inverse_steps_;
+    std::vector<float> values_;
+};
+} // namespace psn
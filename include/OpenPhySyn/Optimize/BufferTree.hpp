@@ -38,11 +38,16 @@
 #include "opendb/geom.h"
 
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace psn
 {
 
 class Psn;
+class BufferTreeArena;
 
 enum BufferMode
 {
@@ -80,7 +85,8 @@ class BufferTree
     float                       wire_delay_or_slew_;   // Wire delay
     float                       cost_;                 // Tree cost
     Point                       location_;             // Buffer location
-    std::shared_ptr<BufferTree> left_, right_;         // Left and right nodes
+    BufferTree *                left_, *right_;        // Left and right nodes
+    BufferTreeArena*            arena_;                // Owning arena
     LibraryCell*                buffer_cell_;          // Buffer cell type
     InstanceTerm*               pin_;                  // Buffered pin
     LibraryTerm*                library_pin_;          // Buffered pin type
@@ -99,10 +105,10 @@ public:
                InstanceTerm* pin = nullptr, LibraryCell* buffer_cell = nullptr,
                int        polarity    = 0,
                BufferMode buffer_mode = BufferMode::TimingDriven);
-    BufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-               std::shared_ptr<BufferTree> right, Point location);
-    BufferTree (const BufferTree&) = delete;
-    BufferTree& operator= (const BufferTree&) = delete;
+    BufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+               Point location);
+    BufferTree(const BufferTree&) = delete;
+    BufferTree& operator=(const BufferTree&) = delete;
     BufferTree(BufferTree&&) = delete;
     BufferTree& operator=(BufferTree&&) = delete;
     float         totalCapacitance() const;
@@ -152,8 +158,12 @@ public:
     LibraryTerm*                 libraryPin() const;
     std::shared_ptr<BufferTree>  left();
     std::shared_ptr<BufferTree>  right();
-    void                         setLeft(std::shared_ptr<BufferTree> left);
-    void                         setRight(std::shared_ptr<BufferTree> right);
+    BufferTree*                  leftNode() const;
+    BufferTree*                  rightNode() const;
+    void                         setLeft(BufferTree* left);
+    void                         setRight(BufferTree* right);
+    BufferTreeArena*             arena() const;
+    void                         setArena(BufferTreeArena* arena);
     bool                         hasUpstreamBufferCell() const;
     bool                         hasBufferCell() const;
     bool                         hasDriverCell() const;
@@ -191,10 +201,82 @@ public:
                         LibraryTerm*  library_pin = nullptr,
                         InstanceTerm* pin         = nullptr,
                         LibraryCell* buffer_cell = nullptr, int polarity = 0);
-    TimerlessBufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-                        std::shared_ptr<BufferTree> right, Point location);
+    TimerlessBufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+                        Point location);
 };
 
+// Pool of the candidate buffer tree nodes of a single net, the nodes link to
+// each other with raw pointers and are all released with the arena.
+class BufferTreeArena : public std::enable_shared_from_this<BufferTreeArena>
+{
+    typedef std::aligned_storage<sizeof(BufferTree), alignof(BufferTree)>::type
+        NodeStorage;
+
+    std::vector<std::unique_ptr<NodeStorage[]>> blocks_;     // Node blocks
+    std::vector<BufferTree*>                    free_nodes_; // Released slots
+    std::vector<std::shared_ptr<BufferTree>>    retained_;   // External trees
+    size_t block_size_; // Number of nodes per block
+    size_t used_;       // Used slots in the last block
+    size_t size_;       // Number of live nodes
+
+public:
+    explicit BufferTreeArena(size_t block_size = 1024);
+    ~BufferTreeArena();
+    BufferTreeArena(const BufferTreeArena&) = delete;
+    BufferTreeArena& operator=(const BufferTreeArena&) = delete;
+
+    // Constructs a BufferTree (or TimerlessBufferTree) node in the arena
+    template <class T = BufferTree, class... Args>
+    T* create(Args&&... args);
+
+    // Destroys a node that is not referenced by any other node so that its
+    // slot can be reused
+    void release(BufferTree* node);
+
+    // Keeps a tree created outside the arena alive with it
+    BufferTree* retain(std::shared_ptr<BufferTree> tree);
+
+    // Shared handle to a node that keeps the whole arena alive
+    std::shared_ptr<BufferTree> share(BufferTree* node);
+
+    size_t size() const;
+};
+
+template <class T, class... Args>
+T*
+BufferTreeArena::create(Args&&... args)
+{
+    static_assert(std::is_base_of<BufferTree, T>::value &&
+                      sizeof(T) == sizeof(BufferTree),
+                  "Only BufferTree nodes can be allocated in the arena");
+    void* slot;
+    if (free_nodes_.size())
+    {
+        slot = free_nodes_.back();
+    }
+    else
+    {
+        if (!blocks_.size() || used_ == block_size_)
+        {
+            blocks_.emplace_back(new NodeStorage[block_size_]);
+            used_ = 0;
+        }
+        slot = &blocks_.back()[used_];
+    }
+    T* node = new (slot) T(std::forward<Args>(args)...);
+    if (free_nodes_.size())
+    {
+        free_nodes_.pop_back();
+    }
+    else
+    {
+        used_++;
+    }
+    size_++;
+    node->setArena(this);
+    return node;
+}
+
 // Options to customize the optimization
 class OptimizationOptions
 {
@@ -237,6 +319,12 @@ public:
         current_iteration                = 0;
         capacitance_pessimism_factor     = 1.0;
         transition_pessimism_factor      = 1.0;
+        parallel_threads                 = 1;
+        parallel_batch_size              = 256;
+        max_candidates                   = 0;
+        candidate_required_grid          = 1E-12; // 1ps
+        candidate_capacitance_grid       = 1E-15; // 1fF
+        squeeze_candidates               = false;
     }
     float initial_area;             // Area before the optimization
     int   max_iterations;           // Maximum number of optimization iterations
@@ -291,38 +379,104 @@ public:
                                         // violations
     float transition_pessimism_factor;  // Scaling factor for transition
                                         // violations
+    int parallel_threads;    // Number of threads used to build the candidate
+                             // buffer trees (1 for serial)
+    int parallel_batch_size; // Maximum number of independent nets buffered
+                             // in one parallel batch
+    int   max_candidates; // Maximum candidates kept per Steiner point (0 for
+                          // no limit)
+    float candidate_required_grid;    // Required time (or slew) quantization
+                                      // step of bounded candidate sets
+    float candidate_capacitance_grid; // Capacitance quantization step of
+                                      // bounded candidate sets
+    bool squeeze_candidates; // Drop merged candidates under the (capacitance,
+                             // required) convex hull
+};
+
+// Summary of the candidates dropped by bounded pruning
+struct CandidateBoundStats
+{
+    CandidateBoundStats()
+        : evaluated_candidates(0),
+          dropped_candidates(0),
+          bounded_points(0),
+          max_required_loss(0.0)
+    {
+    }
+    size_t evaluated_candidates; // Candidates reaching the bound check
+    size_t dropped_candidates;   // Candidates dropped by the grid or the limit
+    size_t bounded_points;       // Steiner points that exceeded the limit
+    float  max_required_loss;    // Largest required time (or slew) given up
+                                 // for a cheaper candidate in a grid cell
 };
 
 // Represents a set of non-dominatd candidate buffer trees.
 class BufferSolution
 {
-    std::vector<std::shared_ptr<BufferTree>> buffer_trees_;
-    BufferMode                               mode_;
+    std::vector<BufferTree*>         buffer_trees_;
+    BufferMode                       mode_;
+    std::shared_ptr<BufferTreeArena> arena_; // Shared by all the solutions
+                                             // of the same net
+    CandidateBoundStats              bound_stats_; // Bounded pruning summary
+
+    // Pruning keys of a candidate, evaluated once per prune call
+    struct PruneCandidate
+    {
+        BufferTree* tree;
+        float       key;         // Sweep order key
+        float       x, y;        // Dominance keys, lower is better
+        float       capacitance; // Total capacitance
+        float       required;    // Total required time
+        float       cost;
+    };
+
+    // Drops candidates dominated in (x, y) by an earlier survivor
+    static void paretoSweep(std::vector<PruneCandidate>& candidates,
+                            float x_threshold, float y_threshold,
+                            bool strict_x);
+    // Drops candidates under the (capacitance, required) convex hull
+    static void squeeze(std::vector<PruneCandidate>& candidates);
+
+    // Pending Steiner point of the iterative bottom-up traversal
+    struct BottomUpFrame
+    {
+        SteinerPoint pt;
+        SteinerPoint prev;
+        bool         expanded; // Children already pushed
+    };
+
+    // Iterative post-order bottom-up shared by bottomUp and
+    // bottomUpWithResynthesis; mapping_terminals is null without resynthesis
+    static std::shared_ptr<BufferSolution> bottomUpTraversal(
+        Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
+        SteinerPoint prev, const std::shared_ptr<const SteinerTree>& st_tree,
+        std::unique_ptr<OptimizationOptions>&                 options,
+        std::vector<std::shared_ptr<LibraryCellMappingNode>>* mapping_terminals);
 
 public:
-    ~BufferSolution() {
-        
-    }
-    BufferSolution(BufferMode buffer_mode = BufferMode::TimingDriven);
+    ~BufferSolution() = default;
+    BufferSolution(BufferMode buffer_mode = BufferMode::TimingDriven,
+                   std::shared_ptr<BufferTreeArena> arena = nullptr);
     BufferSolution(Psn* psn_inst, std::shared_ptr<BufferSolution>& left,
                    std::shared_ptr<BufferSolution>& right, Point location,
                    LibraryCell* upstream_res_cell,
                    float        minimum_upstream_res_or_max_slew,
-                   BufferMode   buffer_mode = BufferMode::TimingDriven);
-    BufferSolution (const BufferSolution&) = delete;
-    BufferSolution& operator= (const BufferSolution&) = delete;
+                   BufferMode   buffer_mode        = BufferMode::TimingDriven,
+                   bool         squeeze_candidates = false);
+    BufferSolution(const BufferSolution&) = delete;
+    BufferSolution& operator=(const BufferSolution&) = delete;
     BufferSolution(BufferSolution&&) = delete;
     BufferSolution& operator=(BufferSolution&&) = delete;
     // van Ginneken buffer algorithm bottom-up
     static std::shared_ptr<BufferSolution>
     bottomUp(Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
-             SteinerPoint prev, std::shared_ptr<SteinerTree> st_tree,
+             SteinerPoint prev, std::shared_ptr<const SteinerTree> st_tree,
              std::unique_ptr<OptimizationOptions>& options);
 
     // van Ginneken buffer algorithm bottom-up with resynthesis support
     static std::shared_ptr<BufferSolution> bottomUpWithResynthesis(
         Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
-        SteinerPoint prev, std::shared_ptr<SteinerTree> st_tree,
+        SteinerPoint prev, std::shared_ptr<const SteinerTree> st_tree,
         std::unique_ptr<OptimizationOptions>&                 options,
         std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals);
 
@@ -344,17 +498,27 @@ public:
     void mergeBranches(Psn* psn_inst, std::shared_ptr<BufferSolution>& left,
                        std::shared_ptr<BufferSolution>& right, Point location,
                        LibraryCell* upstream_res_cell,
-                       float        minimum_upstream_res_or_max_slew);
+                       float        minimum_upstream_res_or_max_slew,
+                       bool         squeeze_candidates = false);
 
     // Add new candidate tree
     void addTree(std::shared_ptr<BufferTree>& tree);
+    void addTree(BufferTree* tree);
 
     // Returns included candidate trees
-    std::vector<std::shared_ptr<BufferTree>>& bufferTrees();
+    std::vector<std::shared_ptr<BufferTree>> bufferTrees();
+    std::shared_ptr<BufferTree>              bufferTree(size_t index);
+    std::vector<BufferTree*>&                trees();
+
+    // Returns the arena owning the candidate nodes
+    std::shared_ptr<BufferTreeArena> arena() const;
 
     // Addd wire parasitics
     void addWireDelayAndCapacitance(float wire_res, float wire_cap);
     void addWireSlewAndCapacitance(float wire_res, float wire_cap);
+    // Extends the wire above each tree with an upstream segment, for trees
+    // that already carry the wire from a pass-through Steiner point
+    void extendWireDelayAndCapacitance(float wire_res, float wire_cap);
 
     // Add leaf nodes
     void addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
@@ -369,8 +533,15 @@ public:
         std::vector<LibraryCell*>& inverter_lib,
         std::vector<std::shared_ptr<LibraryCellMappingNode>>&
             mappings_terminals);
-    void addUpstreamReferences(Psn*                        psn_inst,
-                               std::shared_ptr<BufferTree> base_buffer_tree);
+    void addUpstreamReferences(Psn* psn_inst, BufferTree* base_buffer_tree);
+
+    // Keep at most max_candidates trees: the best candidate of each
+    // (capacitance, required time) grid cell, then an even sample of each
+    // polarity along the capacitance axis that always includes its best
+    // required time (or slew) candidate
+    void boundCandidates(int max_candidates, float required_grid,
+                         float capacitance_grid, CandidateBoundStats& stats);
+    const CandidateBoundStats& boundStats() const;
 
     // Returns the maximum required time tree with driver resizing
     std::shared_ptr<BufferTree>
@@ -416,11 +587,13 @@ public:
     static bool isLessOrEqual(float first, float second, float threshold);
     static bool isGreaterOrEqual(float first, float second, float threshold);
 
-    // Prune buffer trees
+    // Prune buffer trees, squeezing keeps only the (capacitance, required)
+    // convex hull which is exact for a linear upstream resistance only
     void prune(Psn* psn_inst, LibraryCell* upstream_res_cell,
                float       minimum_upstream_res_or_max_slew,
                const float cap_prune_threshold  = 1E-6F,
-               const float cost_prune_threshold = 1E-6F);
+               const float cost_prune_threshold = 1E-6F,
+               bool        squeeze_candidates   = false);
 
     // Not used
     void       setMode(BufferMode buffer_mode);
@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cmath>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -67,11 +69,66 @@ public:
         return pt1.x() == pt2.x() && pt1.y() == pt2.y();
     }
 };
+// Construction method of a Steiner tree
+enum class SteinerMethod
+{
+    Flute,       // Flute with the requested accuracy
+    SpanningTree // Steinerized spanning tree for nets above the Flute degree
+                 // limit
+};
+
+// Number of trees built by each method since the last reset, full parasitics
+// extraction and repair_timing reset and report them
+struct SteinerStats
+{
+    SteinerStats()
+        : flute_nets(0), spanning_tree_nets(0), max_spanning_tree_degree(0)
+    {
+    }
+    size_t flute_nets;
+    size_t spanning_tree_nets;
+    size_t max_spanning_tree_degree;
+};
+
+// Wire timing of a Steiner tree from its driver, each branch uses the same
+// pi model committed to the STA by DatabaseHandler::calculateParasitics
+struct SteinerTiming
+{
+    SteinerTiming() : driver_load(0.0)
+    {
+    }
+    // Sink slew given the driver output slew, combined as the root sum of
+    // squares of the two slews
+    float
+    sinkSlew(size_t index, float driver_slew) const
+    {
+        return std::sqrt(driver_slew * driver_slew +
+                         sink_slews[index] * sink_slews[index]);
+    }
+    float                      driver_load; // Wire and sink pins capacitance
+    std::vector<InstanceTerm*> sinks;
+    std::vector<float>         sink_delays; // Elmore delay from the driver
+    std::vector<float>         sink_slews;  // Wire slew degradation
+};
+
 class SteinerTree
 {
 public:
+    // Nets with more pins than the handler Flute degree limit use the
+    // spanning tree heuristic instead of Flute
     static std::unique_ptr<SteinerTree> create(Net* net, Psn* psn_inst,
                                                int flute_accuracy = 3);
+    // Trees of the nets in input order, nullptr for nets with less than two
+    // pins. The pins are gathered in one serial database walk and the trees
+    // are then built on up to threads workers (serially without taskflow).
+    static std::vector<std::unique_ptr<SteinerTree>>
+    createMany(const std::vector<Net*>& nets, Psn* psn_inst,
+               int flute_accuracy = 3, int threads = 1);
+
+    static SteinerStats statistics();
+    static void         resetStatistics();
+
+    SteinerMethod method() const;
 
     DefDbu distance(SteinerPoint& from, SteinerPoint& to) const;
 
@@ -96,8 +153,17 @@ public:
 
     SteinerPoint top() const; // First point after the driver
 
+    // Subtree queries are constant time, the pin capacitance, wirelength
+    // and sink count of every subtree are summed once on construction
     float  totalLoad(float cap_per_micron) const;
     float  subtreeLoad(float cap_per_micron, SteinerPoint pt) const;
+    int    subtreeSinkCount(SteinerPoint pt) const;
+
+    // Elmore delay and slew degradation of every sink in one pass over the
+    // tree, without building STA parasitics. Uses the handler wire RC unless
+    // given.
+    SteinerTiming wireTiming() const;
+    SteinerTiming wireTiming(float res_per_micron, float cap_per_micron) const;
     float  pinsCapacitance() const;
     size_t pinCount() const;
 
@@ -105,31 +171,68 @@ public:
     float                      subtreeWirelength(SteinerPoint pt) const;
     std::vector<InstanceTerm*> pins() const;
 
-    InstanceTerm* alias(SteinerPoint pt);
+    InstanceTerm* alias(SteinerPoint pt) const;
 
     ~SteinerTree();
 
 private:
     void validatePoint(SteinerPoint pt) const;
+    // Pins of a net with everything the tree needs from the database, in
+    // the connectedPins order
+    struct NetPins
+    {
+        Net*                       net;
+        std::vector<InstanceTerm*> pins;
+        std::vector<FLUTE_DTYPE>   x;
+        std::vector<FLUTE_DTYPE>   y;
+        std::vector<float>         capacitance;
+        int                        driver; // -1 without a driver pin
+    };
+    static void gatherPins(Net* net, Psn* psn_inst, NetPins& net_pins);
+    // Does not query the database, safe to call from worker threads
+    static std::unique_ptr<SteinerTree> build(NetPins& net_pins, Psn* psn_inst,
+                                              int flute_accuracy);
+
     void populateSides();
-    void populateSides(SteinerPoint from, SteinerPoint to,
-                       std::vector<SteinerPoint>& adj1,
-                       std::vector<SteinerPoint>& adj2,
-                       std::vector<SteinerPoint>& adj3);
-    void populateSides(SteinerPoint from, SteinerPoint to, SteinerPoint adj,
-                       std::vector<SteinerPoint>& adj1,
-                       std::vector<SteinerPoint>& adj2,
-                       std::vector<SteinerPoint>& adj3);
-    SteinerTree(Flute::Tree tree, std::vector<InstanceTerm*> pins,
-                Psn* psn_inst);
-    Flute::Tree                tree_;
+    void populateSubtrees(const std::vector<float>& point_capacitance);
+    // Takes ownership of the Flute tree
+    SteinerTree(Flute::Tree tree, const NetPins& net_pins, Psn* psn_inst);
+
+    // O(n log n) rectilinear Steiner tree in the Flute tree layout: the
+    // minimum spanning tree of the k-nearest-neighbor graph is rooted at the
+    // driver, every pin with fanout is split into Steiner points at its
+    // location and the Steiner points are then moved to the median of their
+    // neighbors.
+    static Flute::Tree spanningTree(int degree, FLUTE_DTYPE* x, FLUTE_DTYPE* y,
+                                    int root);
+    // Edges from every pin to its nearest neighbors using a k-d tree
+    static void nearestNeighborEdges(
+        int degree, FLUTE_DTYPE* x, FLUTE_DTYPE* y, int neighbors,
+        std::vector<std::pair<DefDbu, std::pair<int, int>>>& edges);
+
+    static std::atomic<size_t> flute_nets_;
+    static std::atomic<size_t> spanning_tree_nets_;
+    static std::atomic<size_t> max_spanning_tree_degree_;
+
+    SteinerMethod              method_;
     std::vector<InstanceTerm*> pins_;
+
+    // Flat per-point arrays, pins are the first pinCount() points
+    std::vector<DefDbu>        x_;
+    std::vector<DefDbu>        y_;
+    std::vector<SteinerPoint>  parent_; // Flute branch neighbor
     std::vector<SteinerPoint>  left_;
     std::vector<SteinerPoint>  right_;
-    std::vector<InstanceTerm*> point_pin_map_;
-    std::unordered_map<Point, InstanceTerm*, PointHash, PointEqual> pin_loc_;
-    Psn*                                                            psn_;
-    Net*                                                            net_;
+    std::vector<InstanceTerm*> point_pin_;   // nullptr for Steiner points
+    std::vector<InstanceTerm*> alias_;       // Pin at the point location
+    std::vector<DefDbu>        edge_length_; // Length of the branch to parent_
+    std::vector<int64_t>       subtree_length_;      // In DBU, below the point
+    std::vector<float>         subtree_capacitance_; // Sink pins capacitance
+    std::vector<int>           subtree_sinks_;
+    std::vector<SteinerPoint>  order_; // From the driver, parents first
+    SteinerPoint               driver_;
+    Psn*                       psn_;
+    Net*                       net_;
 };
 class SteinerBranch
 {
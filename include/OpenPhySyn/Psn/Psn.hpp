@@ -42,6 +42,7 @@
 #include "sta/ConcreteNetwork.hh"
 
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 
 namespace psn
@@ -105,7 +106,11 @@ public:
 
     virtual void clearDatabase();
 
+    // Decodes the Flute lookup tables at most once
     virtual int initializeFlute();
+    // Called before every Flute query, the tables are loaded on first use
+    // unless Flute is initialized by the host application
+    void ensureFluteInitialized();
 
     static void setupLegalizer();
 
@@ -127,6 +132,8 @@ private:
     Database*         db_;
     DatabaseHandler*  db_handler_;
     std::string       exec_path_;
+    bool              lazy_flute_; // Load Flute tables in the first query
+    std::once_flag    flute_init_flag_;
 
     std::vector<psn::TransformHandler> handlers_;
 
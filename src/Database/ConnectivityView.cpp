@@ -0,0 +1,512 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Database/ConnectivityView.hpp"
+
+#include "sta/Network.hh"
+#include "sta/PortDirection.hh"
+
+#include <algorithm>
+
+namespace psn
+{
+PinSpan::PinSpan(InstanceTerm* const* begin, InstanceTerm* const* end)
+    : begin_(begin), end_(end)
+{
+}
+InstanceTerm* const*
+PinSpan::begin() const
+{
+    return begin_;
+}
+InstanceTerm* const*
+PinSpan::end() const
+{
+    return end_;
+}
+size_t
+PinSpan::size() const
+{
+    return end_ - begin_;
+}
+bool
+PinSpan::empty() const
+{
+    return begin_ == end_;
+}
+InstanceTerm*
+PinSpan::operator[](size_t index) const
+{
+    return begin_[index];
+}
+
+ConnectivityView::ConnectivityView()
+    : network_(nullptr), built_(false), stale_pool_size_(0)
+{
+}
+
+void
+ConnectivityView::build(sta::Network* network)
+{
+    clear();
+    network_ = network;
+    built_   = true;
+
+    auto inst_iter = network_->leafInstanceIterator();
+    while (inst_iter->hasNext())
+    {
+        addInstance(inst_iter->next());
+    }
+    delete inst_iter;
+    auto net_iter = network_->netIterator(network_->topInstance());
+    while (net_iter->hasNext())
+    {
+        addNet(net_iter->next());
+    }
+    delete net_iter;
+    refresh();
+}
+void
+ConnectivityView::clear()
+{
+    network_         = nullptr;
+    built_           = false;
+    stale_pool_size_ = 0;
+    pool_.clear();
+    nets_.clear();
+    net_rows_.clear();
+    net_drivers_.clear();
+    net_stale_.clear();
+    stale_nets_.clear();
+    net_ids_.clear();
+    instances_.clear();
+    instance_rows_.clear();
+    instance_stale_.clear();
+    stale_instances_.clear();
+    instance_ids_.clear();
+    pins_.clear();
+    pin_ids_.clear();
+}
+bool
+ConnectivityView::built() const
+{
+    return built_;
+}
+void
+ConnectivityView::refresh()
+{
+    if (stale_instances_.empty() && stale_nets_.empty())
+    {
+        return;
+    }
+    // Instances first so that new pins get their ids in instance order
+    for (auto inst_id : stale_instances_)
+    {
+        if (instances_[inst_id])
+        {
+            gatherInstance(inst_id);
+        }
+        instance_stale_[inst_id] = false;
+    }
+    stale_instances_.clear();
+    for (auto net_id : stale_nets_)
+    {
+        if (nets_[net_id])
+        {
+            gatherNet(net_id);
+        }
+        net_stale_[net_id] = false;
+    }
+    stale_nets_.clear();
+    if (stale_pool_size_ > pool_.size() / 2)
+    {
+        compact();
+    }
+}
+
+void
+ConnectivityView::addNet(Net* net)
+{
+    if (!built_ || !net)
+    {
+        return;
+    }
+    if (net_ids_.count(net))
+    {
+        invalidate(net);
+        return;
+    }
+    int net_id    = nets_.size();
+    net_ids_[net] = net_id;
+    nets_.push_back(net);
+    net_rows_.resize(net_rows_.size() + 4, pool_.size());
+    net_drivers_.push_back(-1);
+    net_stale_.push_back(true);
+    stale_nets_.push_back(net_id);
+}
+void
+ConnectivityView::addInstance(Instance* inst)
+{
+    if (!built_ || !inst)
+    {
+        return;
+    }
+    if (instance_ids_.count(inst))
+    {
+        invalidate(inst);
+        return;
+    }
+    int inst_id         = instances_.size();
+    instance_ids_[inst] = inst_id;
+    instances_.push_back(inst);
+    instance_rows_.resize(instance_rows_.size() + 4, pool_.size());
+    instance_stale_.push_back(true);
+    stale_instances_.push_back(inst_id);
+}
+void
+ConnectivityView::invalidate(Net* net)
+{
+    if (!built_ || !net)
+    {
+        return;
+    }
+    int net_id = netId(net);
+    if (net_id < 0)
+    {
+        addNet(net);
+    }
+    else if (!net_stale_[net_id])
+    {
+        net_stale_[net_id] = true;
+        stale_nets_.push_back(net_id);
+    }
+}
+void
+ConnectivityView::invalidate(Instance* inst)
+{
+    if (!built_ || !inst)
+    {
+        return;
+    }
+    int inst_id = instanceId(inst);
+    if (inst_id < 0)
+    {
+        addInstance(inst);
+    }
+    else if (!instance_stale_[inst_id])
+    {
+        instance_stale_[inst_id] = true;
+        stale_instances_.push_back(inst_id);
+    }
+    // The pins of a replaced cell may differ, so their nets are re-gathered
+    auto pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext())
+    {
+        invalidate(network_->net(pin_iter->next()));
+    }
+    delete pin_iter;
+}
+void
+ConnectivityView::remove(Net* net)
+{
+    int net_id = built_ ? netId(net) : -1;
+    if (net_id < 0)
+    {
+        return;
+    }
+    size_t row = net_id * 4;
+    stale_pool_size_ += net_rows_[row + 3] - net_rows_[row];
+    std::fill(net_rows_.begin() + row, net_rows_.begin() + row + 4,
+              net_rows_[row]);
+    net_drivers_[net_id] = -1;
+    nets_[net_id]        = nullptr;
+    net_ids_.erase(net);
+}
+void
+ConnectivityView::remove(Instance* inst)
+{
+    int inst_id = built_ ? instanceId(inst) : -1;
+    if (inst_id < 0)
+    {
+        return;
+    }
+    auto pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext())
+    {
+        auto pin = pin_iter->next();
+        invalidate(network_->net(pin));
+        auto pin_itr = pin_ids_.find(pin);
+        if (pin_itr != pin_ids_.end())
+        {
+            pins_[pin_itr->second] = nullptr;
+            pin_ids_.erase(pin_itr);
+        }
+    }
+    delete pin_iter;
+    size_t row = inst_id * 4;
+    stale_pool_size_ += instance_rows_[row + 3] - instance_rows_[row];
+    std::fill(instance_rows_.begin() + row, instance_rows_.begin() + row + 4,
+              instance_rows_[row]);
+    instances_[inst_id] = nullptr;
+    instance_ids_.erase(inst);
+}
+
+int
+ConnectivityView::netId(const Net* net) const
+{
+    auto net_itr = net_ids_.find(net);
+    return net_itr != net_ids_.end() ? net_itr->second : -1;
+}
+int
+ConnectivityView::instanceId(const Instance* inst) const
+{
+    auto inst_itr = instance_ids_.find(inst);
+    return inst_itr != instance_ids_.end() ? inst_itr->second : -1;
+}
+int
+ConnectivityView::pinId(const InstanceTerm* pin) const
+{
+    auto pin_itr = pin_ids_.find(pin);
+    return pin_itr != pin_ids_.end() ? pin_itr->second : -1;
+}
+Net*
+ConnectivityView::net(int net_id) const
+{
+    return nets_[net_id];
+}
+Instance*
+ConnectivityView::instance(int inst_id) const
+{
+    return instances_[inst_id];
+}
+InstanceTerm*
+ConnectivityView::pin(int pin_id) const
+{
+    return pins_[pin_id];
+}
+size_t
+ConnectivityView::netCount() const
+{
+    return nets_.size();
+}
+size_t
+ConnectivityView::instanceCount() const
+{
+    return instances_.size();
+}
+size_t
+ConnectivityView::pinCount() const
+{
+    return pins_.size();
+}
+
+InstanceTerm*
+ConnectivityView::driver(const Net* net) const
+{
+    int net_id = netId(net);
+    if (net_id < 0 || net_drivers_[net_id] < 0)
+    {
+        return nullptr;
+    }
+    return pins_[net_drivers_[net_id]];
+}
+int
+ConnectivityView::driverId(int net_id) const
+{
+    return net_drivers_[net_id];
+}
+PinSpan
+ConnectivityView::pins(const Net* net) const
+{
+    return pins(netId(net));
+}
+PinSpan
+ConnectivityView::pins(int net_id) const
+{
+    return rowSpan(net_rows_, net_id, 0, 1);
+}
+PinSpan
+ConnectivityView::fanoutPins(const Net* net, bool include_top_level) const
+{
+    return fanoutPins(netId(net), include_top_level);
+}
+PinSpan
+ConnectivityView::fanoutPins(int net_id, bool include_top_level) const
+{
+    return rowSpan(net_rows_, net_id, 1, include_top_level ? 3 : 2);
+}
+PinSpan
+ConnectivityView::pins(const Instance* inst) const
+{
+    return rowSpan(instance_rows_, instanceId(inst), 0, 1);
+}
+PinSpan
+ConnectivityView::inputPins(const Instance* inst) const
+{
+    return rowSpan(instance_rows_, instanceId(inst), 1, 2);
+}
+PinSpan
+ConnectivityView::outputPins(const Instance* inst) const
+{
+    return rowSpan(instance_rows_, instanceId(inst), 2, 3);
+}
+
+PinSpan
+ConnectivityView::rowSpan(const std::vector<size_t>& rows, int id, int first,
+                          int last) const
+{
+    if (id < 0)
+    {
+        return PinSpan(nullptr, nullptr);
+    }
+    size_t row = id * 4;
+    return PinSpan(pool_.data() + rows[row + first],
+                   pool_.data() + rows[row + last]);
+}
+int
+ConnectivityView::pinIdOrAdd(InstanceTerm* pin)
+{
+    auto pin_itr = pin_ids_.find(pin);
+    if (pin_itr != pin_ids_.end())
+    {
+        return pin_itr->second;
+    }
+    int pin_id    = pins_.size();
+    pin_ids_[pin] = pin_id;
+    pins_.push_back(pin);
+    return pin_id;
+}
+void
+ConnectivityView::gatherNet(int net_id)
+{
+    Net*   net = nets_[net_id];
+    size_t row = net_id * 4;
+    stale_pool_size_ += net_rows_[row + 3] - net_rows_[row];
+    net_drivers_[net_id] = -1;
+
+    net_rows_[row] = pool_.size();
+    auto pin_iter  = network_->pinIterator(net);
+    while (pin_iter->hasNext())
+    {
+        auto pin    = pin_iter->next();
+        int  pin_id = pinIdOrAdd(pin);
+        pool_.push_back(pin);
+        if (net_drivers_[net_id] < 0 && network_->instance(pin) &&
+            network_->direction(pin)->isOutput())
+        {
+            net_drivers_[net_id] = pin_id;
+        }
+    }
+    delete pin_iter;
+    net_rows_[row + 1] = pool_.size();
+    for (size_t i = net_rows_[row]; i < net_rows_[row + 1]; i++)
+    {
+        auto pin = pool_[i];
+        if (network_->instance(pin) &&
+            network_->direction(pin) == sta::PortDirection::input())
+        {
+            pool_.push_back(pin);
+        }
+    }
+    net_rows_[row + 2] = pool_.size();
+    auto connected_iter = network_->connectedPinIterator(net);
+    while (connected_iter->hasNext())
+    {
+        auto pin = connected_iter->next();
+        if (network_->isTopLevelPort(pin) &&
+            network_->direction(pin)->isOutput())
+        {
+            pinIdOrAdd(pin);
+            pool_.push_back(pin);
+        }
+    }
+    delete connected_iter;
+    net_rows_[row + 3] = pool_.size();
+}
+void
+ConnectivityView::gatherInstance(int inst_id)
+{
+    Instance* inst = instances_[inst_id];
+    size_t    row  = inst_id * 4;
+    stale_pool_size_ += instance_rows_[row + 3] - instance_rows_[row];
+
+    instance_rows_[row] = pool_.size();
+    auto pin_iter       = network_->pinIterator(inst);
+    while (pin_iter->hasNext())
+    {
+        auto pin = pin_iter->next();
+        pinIdOrAdd(pin);
+        pool_.push_back(pin);
+    }
+    delete pin_iter;
+    instance_rows_[row + 1] = pool_.size();
+    for (size_t i = instance_rows_[row]; i < instance_rows_[row + 1]; i++)
+    {
+        auto pin = pool_[i];
+        if (network_->direction(pin) == sta::PortDirection::input())
+        {
+            pool_.push_back(pin);
+        }
+    }
+    instance_rows_[row + 2] = pool_.size();
+    for (size_t i = instance_rows_[row]; i < instance_rows_[row + 1]; i++)
+    {
+        auto pin = pool_[i];
+        if (network_->direction(pin) == sta::PortDirection::output())
+        {
+            pool_.push_back(pin);
+        }
+    }
+    instance_rows_[row + 3] = pool_.size();
+}
+void
+ConnectivityView::compact()
+{
+    std::vector<InstanceTerm*> pool;
+    pool.reserve(pool_.size() - stale_pool_size_);
+    for (auto rows : {&net_rows_, &instance_rows_})
+    {
+        for (size_t row = 0; row < rows->size(); row += 4)
+        {
+            size_t begin = (*rows)[row];
+            size_t shift = pool.size();
+            pool.insert(pool.end(), pool_.begin() + begin,
+                        pool_.begin() + (*rows)[row + 3]);
+            for (size_t i = 0; i < 4; i++)
+            {
+                (*rows)[row + i] = (*rows)[row + i] - begin + shift;
+            }
+        }
+    }
+    pool_.swap(pool);
+    stale_pool_size_ = 0;
+}
+} // namespace psn
@@ -30,6 +30,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 #include "OpenPhySyn/Database/DatabaseHandler.hpp"
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <set>
 #include "OpenPhySyn/Database/Types.hpp"
@@ -50,6 +51,7 @@
 #include "sta/Fuzzy.hh"
 #include "sta/Graph.hh"
 #include "sta/GraphDelayCalc.hh"
+#include "sta/Levelize.hh"
 #include "sta/Liberty.hh"
 #include "sta/MinMax.hh"
 #include "sta/Parasitics.hh"
@@ -81,7 +83,19 @@ DatabaseHandler::DatabaseHandler(Psn* psn_inst, DatabaseSta* sta)
       has_library_cell_mappings_(false),
       capacitance_limits_initialized_(false),
       slew_limits_initialized_(false),
-      fanout_limits_initialized_(false)
+      fanout_limits_initialized_(false),
+      concurrent_queries_(false),
+      concurrent_generation_(0),
+      concurrent_res_per_micron_(0.0),
+      concurrent_cap_per_micron_(0.0),
+      has_nldm_tables_(false),
+      has_cell_attributes_(false),
+      level_graph_(nullptr),
+      level_drivers_valid_(false),
+      level_order_stale_(true),
+      parasitics_threads_(1),
+      steiner_flute_degree_limit_(256),
+      characterization_dirty_(false)
 {
     // Use default corner for now
     corner_                      = sta_->findCorner("default");
@@ -102,6 +116,12 @@ DatabaseHandler::DatabaseHandler(Psn* psn_inst, DatabaseSta* sta)
 std::vector<InstanceTerm*>
 DatabaseHandler::pins(Net* net) const
 {
+    auto view = connectivity();
+    if (view && view->netId(net) >= 0)
+    {
+        auto net_pins = view->pins(net);
+        return std::vector<InstanceTerm*>(net_pins.begin(), net_pins.end());
+    }
     std::vector<InstanceTerm*> terms;
     auto                       pin_iter = network()->pinIterator(net);
     while (pin_iter->hasNext())
@@ -114,6 +134,12 @@ DatabaseHandler::pins(Net* net) const
 std::vector<InstanceTerm*>
 DatabaseHandler::pins(Instance* inst) const
 {
+    auto view = connectivity();
+    if (view && view->instanceId(inst) >= 0)
+    {
+        auto inst_pins = view->pins(inst);
+        return std::vector<InstanceTerm*>(inst_pins.begin(), inst_pins.end());
+    }
     std::vector<InstanceTerm*> terms;
     auto                       pin_iter = network()->pinIterator(inst);
     while (pin_iter->hasNext())
@@ -199,6 +225,12 @@ DatabaseHandler::clockPins() const
 std::vector<InstanceTerm*>
 DatabaseHandler::inputPins(Instance* inst, bool include_top_level) const
 {
+    auto view = connectivity();
+    if (view && view->instanceId(inst) >= 0)
+    {
+        auto input_pins = view->inputPins(inst);
+        return std::vector<InstanceTerm*>(input_pins.begin(), input_pins.end());
+    }
     auto inst_pins = pins(inst);
     return filterPins(inst_pins, PinDirection::input(), include_top_level);
 }
@@ -206,6 +238,13 @@ DatabaseHandler::inputPins(Instance* inst, bool include_top_level) const
 std::vector<InstanceTerm*>
 DatabaseHandler::outputPins(Instance* inst, bool include_top_level) const
 {
+    auto view = connectivity();
+    if (view && view->instanceId(inst) >= 0)
+    {
+        auto output_pins = view->outputPins(inst);
+        return std::vector<InstanceTerm*>(output_pins.begin(),
+                                          output_pins.end());
+    }
     auto inst_pins = pins(inst);
     return filterPins(inst_pins, PinDirection::output(), include_top_level);
 }
@@ -213,6 +252,13 @@ DatabaseHandler::outputPins(Instance* inst, bool include_top_level) const
 std::vector<InstanceTerm*>
 DatabaseHandler::fanoutPins(Net* pin_net, bool include_top_level) const
 {
+    auto view = connectivity();
+    if (view && view->netId(pin_net) >= 0)
+    {
+        auto fanout_pins = view->fanoutPins(pin_net, include_top_level);
+        return std::vector<InstanceTerm*>(fanout_pins.begin(),
+                                          fanout_pins.end());
+    }
     auto inst_pins = pins(pin_net);
 
     auto filtered_inst_pins =
@@ -239,6 +285,136 @@ DatabaseHandler::fanoutPins(Net* pin_net, bool include_top_level) const
     return filtered_inst_pins;
 }
 
+void
+DatabaseHandler::forEachNet(const NetVisitor& visitor) const
+{
+    auto net_iter = network()->netIterator(network()->topInstance());
+    while (net_iter->hasNext())
+    {
+        visitor(net_iter->next());
+    }
+    delete net_iter;
+}
+void
+DatabaseHandler::forEachPin(Net* net, const PinVisitor& visitor) const
+{
+    auto view = connectivity();
+    if (view && view->netId(net) >= 0)
+    {
+        for (auto pin : view->pins(net))
+        {
+            visitor(pin);
+        }
+        return;
+    }
+    auto pin_iter = network()->pinIterator(net);
+    while (pin_iter->hasNext())
+    {
+        visitor(pin_iter->next());
+    }
+    delete pin_iter;
+}
+void
+DatabaseHandler::forEachPin(Instance* inst, const PinVisitor& visitor) const
+{
+    auto view = connectivity();
+    if (view && view->instanceId(inst) >= 0)
+    {
+        for (auto pin : view->pins(inst))
+        {
+            visitor(pin);
+        }
+        return;
+    }
+    auto pin_iter = network()->pinIterator(inst);
+    while (pin_iter->hasNext())
+    {
+        visitor(pin_iter->next());
+    }
+    delete pin_iter;
+}
+void
+DatabaseHandler::forEachFanoutPin(Net* net, const PinVisitor& visitor,
+                                  bool include_top_level) const
+{
+    auto view = connectivity();
+    if (view && view->netId(net) >= 0)
+    {
+        for (auto pin : view->fanoutPins(net, include_top_level))
+        {
+            visitor(pin);
+        }
+        return;
+    }
+    auto pin_iter = network()->pinIterator(net);
+    while (pin_iter->hasNext())
+    {
+        InstanceTerm* pin = pin_iter->next();
+        if (network()->instance(pin) &&
+            network()->direction(pin) == PinDirection::input())
+        {
+            visitor(pin);
+        }
+    }
+    delete pin_iter;
+    if (include_top_level)
+    {
+        auto itr = network()->connectedPinIterator(net);
+        while (itr->hasNext())
+        {
+            InstanceTerm* term = itr->next();
+            if (network()->isTopLevelPort(term) &&
+                network()->direction(term)->isOutput())
+            {
+                visitor(term);
+            }
+        }
+        delete itr;
+    }
+}
+void
+DatabaseHandler::forEachDriverVertex(const VertexVisitor& visitor) const
+{
+    sta_->ensureGraph();
+    auto                handler_network = network();
+    sta::VertexIterator itr(handler_network->graph());
+    while (itr.hasNext())
+    {
+        Vertex* vtx = itr.next();
+        if (vtx->isDriver(handler_network))
+        {
+            visitor(vtx);
+        }
+    }
+}
+void
+DatabaseHandler::forEachClockNet(const NetVisitor& visitor) const
+{
+    std::unordered_set<Net*>  visited_nets;
+    sta::ClkArrivalSearchPred srch_pred(sta_);
+    sta::BfsFwdIterator       bfs(sta::BfsIndex::other, &srch_pred, sta_);
+    sta::PinSet               clk_pins;
+    sta_->search()->findClkVertexPins(clk_pins);
+    for (auto pin : clk_pins)
+    {
+        Vertex *vert, *bi_vert;
+        network()->graph()->pinVertices(pin, vert, bi_vert);
+        bfs.enqueue(vert);
+        if (bi_vert)
+            bfs.enqueue(bi_vert);
+    }
+    while (bfs.hasNext())
+    {
+        auto vertex = bfs.next();
+        Net* net    = network()->net(vertex->pin());
+        if (visited_nets.insert(net).second)
+        {
+            visitor(net);
+        }
+        bfs.enqueueAdjacentVertices(vertex);
+    }
+}
+
 bool
 DatabaseHandler::isTieHi(Instance* inst) const
 {
@@ -336,19 +512,10 @@ DatabaseHandler::inverterCells() const
         sta::LibertyCellIterator cell_iter(lib);
         while (cell_iter.hasNext())
         {
-            auto cell        = cell_iter.next();
-            auto output_pins = libraryOutputPins(cell);
-            auto input_pins  = libraryInputPins(cell);
-
-            if (!dontUse(cell) && isSingleOutputCombinational(cell) &&
-                input_pins.size() == 1)
+            auto cell = cell_iter.next();
+            if (!dontUse(cell) && isInverter(cell))
             {
-                auto           output_pin  = output_pins[0];
-                sta::FuncExpr* output_func = output_pin->function();
-                if (output_func && output_func->op() == sta::FuncExpr::op_not)
-                {
-                    cells.push_back(cell);
-                }
+                cells.push_back(cell);
             }
         }
     }
@@ -950,6 +1117,12 @@ std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>
 DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
                                 bool include_inverting)
 {
+    std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>> clusters;
+    if (restoreBufferClusters(cluster_threshold, find_superior,
+                              include_inverting, clusters))
+    {
+        return clusters;
+    }
     std::vector<LibraryCell*>        buffer_cells, inverter_cells;
     std::unordered_set<LibraryCell*> superior_buffer_cells,
         superior_inverter_cells;
@@ -984,8 +1157,7 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
     // Get the smallest capacitance/resistance.
     float min_buff_cap = bufferInputCapacitance(buffer_cells[0]);
     float min_buff_resistance =
-        bufferOutputPin(buffer_cells[buffer_cells.size() - 1])
-            ->driveResistance();
+        driveResistance(buffer_cells[buffer_cells.size() - 1]);
     float min_buff_slew      = 20E-12;
     float min_inv_cap        = 0.0;
     float min_inv_resistance = 0.0;
@@ -994,8 +1166,7 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
     {
         min_inv_cap = bufferInputCapacitance(inverter_cells[0]);
         float min_inv_resistance =
-            bufferOutputPin(inverter_cells[inverter_cells.size() - 1])
-                ->driveResistance();
+            driveResistance(inverter_cells[inverter_cells.size() - 1]);
     }
 
     // Find superior buffers/inverters.
@@ -1076,8 +1247,8 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
         input_capacitances[buf] = bufferInputCapacitance(buf);
         drive_capacitances[buf] = maxLoad(buf);
         intrinsic_delays[buf]   = gateDelay(output_pin, min_buff_cap) -
-                                output_pin->driveResistance() * min_buff_cap;
-        driver_conductance[buf] = 1.0 / output_pin->driveResistance();
+                                driveResistance(buf) * min_buff_cap;
+        driver_conductance[buf] = 1.0 / driveResistance(buf);
         max_buff_input_capacitances =
             std::max(max_buff_input_capacitances, input_capacitances[buf]);
         max_buff_drive_capacitance =
@@ -1093,8 +1264,8 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
         input_capacitances[inv] = bufferInputCapacitance(inv);
         drive_capacitances[inv] = maxLoad(inv);
         intrinsic_delays[inv]   = gateDelay(output_pin, min_buff_cap) -
-                                output_pin->driveResistance() * min_buff_cap;
-        driver_conductance[inv] = 1.0 / output_pin->driveResistance();
+                                driveResistance(inv) * min_buff_cap;
+        driver_conductance[inv] = 1.0 / driveResistance(inv);
         max_inv_input_capacitances =
             std::max(max_inv_input_capacitances, input_capacitances[inv]);
         max_inv_drive_capacitance =
@@ -1150,8 +1321,11 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
         buff_vector, buff_distances, cluster_threshold, 0);
     auto inverter_cluster = KCenterClustering::cluster<LibraryCell*>(
         inv_vector, inv_distances, cluster_threshold, 0);
-    return std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>(
-        buffer_cluster, inverter_cluster);
+    clusters.first  = buffer_cluster;
+    clusters.second = inverter_cluster;
+    storeBufferClusters(cluster_threshold, find_superior, include_inverting,
+                        clusters);
+    return clusters;
 }
 std::unordered_set<InstanceTerm*>
 DatabaseHandler::commutativePins(InstanceTerm* term)
@@ -1399,6 +1573,19 @@ DatabaseHandler::arrival(InstanceTerm* term) const
 float
 DatabaseHandler::required(InstanceTerm* term) const
 {
+    if (concurrent_queries_)
+    {
+        // The search is not thread-safe, every load of the batch nets is
+        // expected to be captured by beginConcurrentQueries
+        auto req_itr = concurrent_required_.find(term);
+        if (req_itr == concurrent_required_.end())
+        {
+            PSN_LOG_ERROR("No captured required time for {}", name(term));
+            assert(false);
+            return 0;
+        }
+        return req_itr->second;
+    }
     auto vert = network()->graph()->pinLoadVertex(term);
     auto req  = sta_->vertexRequired(vert, min_max_);
     if (sta::fuzzyInf(req))
@@ -1572,16 +1759,7 @@ DatabaseHandler::isCommutative(LibraryTerm* first, LibraryTerm* second) const
     {
         return false;
     }
-    auto                      output_pins = libraryOutputPins(cell_lib);
-    auto                      input_pins  = libraryInputPins(cell_lib);
-    std::vector<LibraryTerm*> remaining_pins;
-    for (auto& pin : input_pins)
-    {
-        if (pin != first && pin != second)
-        {
-            remaining_pins.push_back(pin);
-        }
-    }
+    auto output_pins = libraryOutputPins(cell_lib);
     for (auto& out : output_pins)
     {
         sta::FuncExpr* func = out->function();
@@ -1591,36 +1769,12 @@ DatabaseHandler::isCommutative(LibraryTerm* first, LibraryTerm* second) const
         }
         if (func->hasPort(first) && func->hasPort(second))
         {
-            std::unordered_map<LibraryTerm*, int> sim_vals;
-            for (int i = 0; i < 2; i++)
+            auto compiled = compiledFunction(out);
+            if (!compiled ||
+                !compiled->symmetric(compiled->variableIndex(first),
+                                     compiled->variableIndex(second)))
             {
-                for (int j = 0; j < 2; j++)
-                {
-
-                    for (int m = 0; m < std::pow(2, remaining_pins.size()); m++)
-                    {
-                        sim_vals[first]  = i;
-                        sim_vals[second] = j;
-                        int temp         = m;
-                        for (auto& rp : remaining_pins)
-                        {
-                            sim_vals[rp] = temp & 1;
-                            temp         = temp >> 1;
-                        }
-                        int first_result =
-                            evaluateFunctionExpression(out, sim_vals);
-
-                        sim_vals[first]  = j;
-                        sim_vals[second] = i;
-                        int second_result =
-                            evaluateFunctionExpression(out, sim_vals);
-                        if (first_result != second_result ||
-                            first_result == -1 || second_result == -1)
-                        {
-                            return false;
-                        }
-                    }
-                }
+                return false;
             }
         }
     }
@@ -1631,33 +1785,26 @@ DatabaseHandler::levelDriverPins(
     bool reverse, std::unordered_set<InstanceTerm*> filter_pins) const
 {
     sta_->ensureGraph();
+    if (!sta_->levelize()->levelized())
+    {
+        level_order_stale_ = true;
+    }
     sta_->ensureLevelized();
-
-    auto handler_network = network();
+    updateLevelDrivers();
 
     std::vector<InstanceTerm*> terms;
-    std::vector<Vertex*>       vertices;
-    sta::VertexIterator        itr(handler_network->graph());
-    while (itr.hasNext())
+    if (!filter_pins.size())
     {
-        Vertex* vtx = itr.next();
-        if (vtx->isDriver(handler_network))
-            vertices.push_back(vtx);
-    }
-    std::sort(
-        vertices.begin(), vertices.end(),
-        [=](const Vertex* v1, const Vertex* v2) -> bool {
-            return (v1->level() < v2->level()) ||
-                   (v1->level() == v2->level() &&
-                    sta::stringLess(handler_network->pathName(v1->pin()),
-                                    handler_network->pathName(v2->pin())));
-        });
-    for (auto& v : vertices)
+        terms = level_order_;
+    }
+    else
     {
-        auto pn = v->pin();
-        if (!filter_pins.size() || filter_pins.count(pn))
+        for (auto& pn : level_order_)
         {
-            terms.push_back(v->pin());
+            if (filter_pins.count(pn))
+            {
+                terms.push_back(pn);
+            }
         }
     }
     if (reverse)
@@ -1666,6 +1813,96 @@ DatabaseHandler::levelDriverPins(
     }
     return terms;
 }
+void
+DatabaseHandler::invalidateLevelDrivers()
+{
+    level_drivers_valid_ = false;
+    level_order_stale_   = true;
+}
+void
+DatabaseHandler::updateLevelDrivers() const
+{
+    auto graph     = sta_->graph();
+    auto vertex_id = [=](InstanceTerm* pin) -> sta::VertexId {
+        return graph->id(graph->pinDrvrVertex(pin));
+    };
+    if (!level_drivers_valid_ || graph != level_graph_)
+    {
+        // Graph order is vertex id order
+        level_drivers_.clear();
+        forEachDriverVertex(
+            [&](Vertex* vtx) { level_drivers_.push_back(vtx->pin()); });
+        added_driver_pins_.clear();
+        removed_driver_pins_.clear();
+        level_graph_         = graph;
+        level_drivers_valid_ = true;
+        level_order_stale_   = true;
+    }
+    if (removed_driver_pins_.size())
+    {
+        level_drivers_.erase(
+            std::remove_if(level_drivers_.begin(), level_drivers_.end(),
+                           [&](InstanceTerm* pin) -> bool {
+                               return removed_driver_pins_.count(pin);
+                           }),
+            level_drivers_.end());
+        removed_driver_pins_.clear();
+        level_order_stale_ = true;
+    }
+    if (level_order_stale_ || added_driver_pins_.size())
+    {
+        // Pins of instances edited outside the handler may have lost their
+        // driver vertex
+        level_drivers_.erase(
+            std::remove_if(level_drivers_.begin(), level_drivers_.end(),
+                           [&](InstanceTerm* pin) -> bool {
+                               return !graph->pinDrvrVertex(pin);
+                           }),
+            level_drivers_.end());
+    }
+    if (added_driver_pins_.size())
+    {
+        for (auto& pin : added_driver_pins_)
+        {
+            if (graph->pinDrvrVertex(pin))
+            {
+                level_drivers_.push_back(pin);
+            }
+        }
+        std::sort(level_drivers_.begin(), level_drivers_.end(),
+                  [&](InstanceTerm* p1, InstanceTerm* p2) -> bool {
+                      return vertex_id(p1) < vertex_id(p2);
+                  });
+        added_driver_pins_.clear();
+        level_order_stale_ = true;
+    }
+    if (!level_order_stale_)
+    {
+        return;
+    }
+    // Counting sort on the levels, stable so ties keep the vertex id order
+    std::vector<size_t> level_starts;
+    for (auto& pin : level_drivers_)
+    {
+        size_t level = graph->pinDrvrVertex(pin)->level();
+        if (level + 1 >= level_starts.size())
+        {
+            level_starts.resize(level + 2, 0);
+        }
+        level_starts[level + 1]++;
+    }
+    for (size_t i = 1; i < level_starts.size(); i++)
+    {
+        level_starts[i] += level_starts[i - 1];
+    }
+    level_order_.resize(level_drivers_.size());
+    for (auto& pin : level_drivers_)
+    {
+        size_t level = graph->pinDrvrVertex(pin)->level();
+        level_order_[level_starts[level]++] = pin;
+    }
+    level_order_stale_ = false;
+}
 
 InstanceTerm*
 DatabaseHandler::faninPin(InstanceTerm* term) const
@@ -1675,6 +1912,11 @@ DatabaseHandler::faninPin(InstanceTerm* term) const
 InstanceTerm*
 DatabaseHandler::faninPin(Net* net) const
 {
+    auto view = connectivity();
+    if (view && view->netId(net) >= 0)
+    {
+        return view->driver(net);
+    }
     auto net_pins = pins(net);
     for (auto& pin : net_pins)
     {
@@ -1707,8 +1949,7 @@ std::vector<Instance*>
 DatabaseHandler::driverInstances() const
 {
     std::set<Instance*> insts_set;
-    for (auto& net : nets())
-    {
+    forEachNet([&](Net* net) {
         InstanceTerm* driverPin = faninPin(net);
         if (driverPin)
         {
@@ -1718,14 +1959,17 @@ DatabaseHandler::driverInstances() const
                 insts_set.insert(inst);
             }
         }
-    }
+    });
     return std::vector<Instance*>(insts_set.begin(), insts_set.end());
 }
 
 unsigned int
 DatabaseHandler::fanoutCount(Net* net, bool include_top_level) const
 {
-    return fanoutPins(net, include_top_level).size();
+    unsigned int count = 0;
+    forEachFanoutPin(
+        net, [&](InstanceTerm*) { count++; }, include_top_level);
+    return count;
 }
 
 Point
@@ -1767,6 +2011,7 @@ DatabaseHandler::location(Instance* inst)
 void
 DatabaseHandler::setLocation(Instance* inst, Point pt)
 {
+    markDirty(inst);
     odb::dbInst* dinst = network()->staToDb(inst);
     dinst->setPlacementStatus(odb::dbPlacementStatus::PLACED);
     dinst->setLocation(pt.getX(), pt.getY());
@@ -1786,9 +2031,19 @@ DatabaseHandler::area(Instance* inst) const
 }
 float
 DatabaseHandler::area(LibraryCell* cell) const
+{
+    auto attributes = cellAttributes(cell);
+    if (attributes)
+    {
+        return attributes->area;
+    }
+    return masterArea(cell);
+}
+float
+DatabaseHandler::masterArea(LibraryCell* cell) const
 {
     odb::dbMaster* master = db_->findMaster(name(cell).c_str());
-    if (master->isCoreAutoPlaceable())
+    if (master && master->isCoreAutoPlaceable())
     {
         return dbuToMeters(master->getWidth()) *
                dbuToMeters(master->getHeight());
@@ -2110,6 +2365,20 @@ DatabaseHandler::slew(LibraryTerm* term, float load_cap, float* tr_slew)
         findTargetLoads();
     }
 
+    auto nldm_arcs = nldmArcs(term);
+    if (nldm_arcs)
+    {
+        float max_slew = -sta::INF;
+        for (auto& arc : *nldm_arcs)
+        {
+            float in_slew =
+                tr_slew ? *tr_slew : target_slews_[arc.input_transition];
+            // Negative slews are clipped like the table model does
+            max_slew = std::max(
+                max_slew, std::max(arc.slew.lookup(in_slew, load_cap), 0.0f));
+        }
+        return max_slew;
+    }
     auto cell = term->libertyCell();
     // Max rise/fall delays.
     sta::Slew                            max_slew = -sta::INF;
@@ -2128,7 +2397,7 @@ DatabaseHandler::slew(LibraryTerm* term, float load_cap, float* tr_slew)
                     tr_slew ? *tr_slew : target_slews_[in_rf->index()];
                 sta::ArcDelay gate_delay;
                 sta::Slew     drvr_slew;
-                sta_->arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
+                arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
                                                 nullptr, 0.0, pvt_, dcalc_ap_,
                                                 gate_delay, drvr_slew);
                 max_slew = std::max(max_slew, drvr_slew);
@@ -2137,14 +2406,46 @@ DatabaseHandler::slew(LibraryTerm* term, float load_cap, float* tr_slew)
     }
     return max_slew;
 }
+void
+DatabaseHandler::slews(LibraryTerm* term, const std::vector<float>& load_caps,
+                       const std::vector<float>& input_slews,
+                       std::vector<float>&       output_slews)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto nldm_arcs = nldmArcs(term);
+    output_slews.resize(load_caps.size());
+    if (!nldm_arcs)
+    {
+        for (size_t i = 0; i < load_caps.size(); i++)
+        {
+            float in_slew   = input_slews[i];
+            output_slews[i] = slew(term, load_caps[i], &in_slew);
+        }
+        return;
+    }
+    std::fill(output_slews.begin(), output_slews.end(), 0.0);
+    std::vector<float> arc_slews(load_caps.size());
+    for (auto& arc : *nldm_arcs)
+    {
+        arc.slew.lookup(input_slews.data(), load_caps.data(), arc_slews.data(),
+                        load_caps.size());
+        // Negative slews are clipped like the table model does
+        for (size_t i = 0; i < load_caps.size(); i++)
+        {
+            output_slews[i] = std::max(output_slews[i], arc_slews[i]);
+        }
+    }
+}
 float
 DatabaseHandler::bufferFixedInputSlew(LibraryCell* buffer_cell, float cap)
 {
-    auto output_pin      = bufferOutputPin(buffer_cell);
+    auto res             = driveResistance(buffer_cell);
     auto min_buff_cap    = bufferInputCapacitance(smallestBufferCell());
-    auto intrinsic_delay = gateDelay(output_pin, min_buff_cap) -
-                           output_pin->driveResistance() * min_buff_cap;
-    auto res = output_pin->driveResistance();
+    auto intrinsic_delay = bufferDelay(buffer_cell, min_buff_cap) -
+                           res * min_buff_cap;
     return res * cap + intrinsic_delay;
 }
 
@@ -2329,7 +2630,24 @@ DatabaseHandler::legalize(int max_displacement)
 {
     if (legalizer_)
     {
-        return legalizer_(max_displacement);
+        // The legalizer moves cells directly in the database, compare the
+        // locations to find the nets that need re-extraction
+        std::vector<std::pair<Instance*, Point>> locations;
+        for (auto& inst : instances())
+        {
+            locations.push_back(std::make_pair(inst, location(inst)));
+        }
+        bool result = legalizer_(max_displacement);
+        for (auto& inst_location : locations)
+        {
+            auto current = location(inst_location.first);
+            if (current.getX() != inst_location.second.getX() ||
+                current.getY() != inst_location.second.getY())
+            {
+                markDirty(inst_location.first);
+            }
+        }
+        return result;
     }
     return false;
 }
@@ -2341,22 +2659,47 @@ DatabaseHandler::isTopLevel(InstanceTerm* term) const
 void
 DatabaseHandler::del(Net* net) const
 {
+    connectivity_.remove(net);
+    level_order_stale_ = true;
+    dirty_nets_.erase(net);
+    {
+        std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+        steiner_trees_.erase(net);
+    }
     sta_->deleteNet(net);
 }
 void
 DatabaseHandler::del(Instance* inst) const
 {
+    markDirty(inst);
+    connectivity_.remove(inst);
+    if (level_drivers_valid_)
+    {
+        forEachPin(inst, [&](InstanceTerm* pin) {
+            if (isDriver(pin))
+            {
+                added_driver_pins_.erase(pin);
+                removed_driver_pins_.insert(pin);
+            }
+        });
+    }
+    level_order_stale_ = true;
     sta_->deleteInstance(inst);
 }
 int
 DatabaseHandler::disconnectAll(Net* net) const
 {
     int count = 0;
+    markDirty(net);
+    level_order_stale_ = true;
+    // Collect the pins first, the snapshot row is only re-gathered once the
+    // net is invalidated after the loop
     for (auto& pin : pins(net))
     {
         sta_->disconnectPin(pin);
         count++;
     }
+    connectivity_.invalidate(net);
 
     return count;
 }
@@ -2366,13 +2709,20 @@ DatabaseHandler::connect(Net* net, InstanceTerm* term) const
 {
     auto inst      = network()->instance(term);
     auto term_port = network()->port(term);
+    markDirty(net);
+    level_order_stale_ = true;
     sta_->connectPin(inst, term_port, net);
+    connectivity_.invalidate(net);
 }
 
 void
 DatabaseHandler::disconnect(InstanceTerm* term) const
 {
+    auto term_net = net(term);
+    markDirty(term_net);
+    level_order_stale_ = true;
     sta_->disconnectPin(term);
+    connectivity_.invalidate(term_net);
 }
 
 void
@@ -2395,7 +2745,18 @@ DatabaseHandler::swapPins(InstanceTerm* first, InstanceTerm* second)
 Instance*
 DatabaseHandler::createInstance(const char* inst_name, LibraryCell* cell)
 {
-    return sta_->makeInstance(inst_name, cell, network()->topInstance());
+    auto inst = sta_->makeInstance(inst_name, cell, network()->topInstance());
+    connectivity_.addInstance(inst);
+    if (level_drivers_valid_)
+    {
+        forEachPin(inst, [&](InstanceTerm* pin) {
+            if (isDriver(pin))
+            {
+                added_driver_pins_.insert(pin);
+            }
+        });
+    }
+    return inst;
 }
 
 void
@@ -2438,6 +2799,7 @@ Net*
 DatabaseHandler::createNet(const char* net_name)
 {
     auto net = sta_->makeNet(net_name, network()->topInstance());
+    connectivity_.addNet(net);
     return net;
 }
 float
@@ -2452,6 +2814,10 @@ DatabaseHandler::resistancePerMicron() const
     {
         PSN_LOG_WARN("Wire RC is not set or invalid");
     }
+    if (concurrent_queries_)
+    {
+        return concurrent_res_per_micron_;
+    }
     if (res_per_micron_callback_)
     {
         return res_per_micron_callback_();
@@ -2465,6 +2831,10 @@ DatabaseHandler::capacitancePerMicron() const
     {
         PSN_LOG_WARN("Wire RC is not set or invalid");
     }
+    if (concurrent_queries_)
+    {
+        return concurrent_cap_per_micron_;
+    }
     if (cap_per_micron_callback_)
     {
         return cap_per_micron_callback_();
@@ -2475,12 +2845,18 @@ DatabaseHandler::capacitancePerMicron() const
 void
 DatabaseHandler::connect(Net* net, Instance* inst, LibraryTerm* port) const
 {
+    markDirty(net);
+    level_order_stale_ = true;
     sta_->connectPin(inst, port, net);
+    connectivity_.invalidate(net);
 }
 void
 DatabaseHandler::connect(Net* net, Instance* inst, Port* port) const
 {
+    markDirty(net);
+    level_order_stale_ = true;
     sta_->connectPin(inst, port, net);
+    connectivity_.invalidate(net);
 }
 
 std::vector<Net*>
@@ -2520,6 +2896,7 @@ DatabaseHandler::setDontUse(std::vector<std::string>& cell_names)
             dont_use_.insert(cell);
         }
     }
+    has_cell_attributes_ = false;
 }
 
 std::string
@@ -2631,10 +3008,26 @@ DatabaseHandler::top() const
 
 DatabaseHandler::~DatabaseHandler()
 {
+    endConcurrentQueries();
+    saveCharacterizationCache();
 }
 void
 DatabaseHandler::clear()
 {
+    dirty_nets_.clear();
+    steiner_trees_.clear();
+    nldm_arcs_.clear();
+    has_nldm_tables_ = false;
+    cell_ids_.clear();
+    cell_attributes_.clear();
+    has_cell_attributes_ = false;
+    compiled_functions_.clear();
+    connectivity_.clear();
+    level_drivers_.clear();
+    level_order_.clear();
+    added_driver_pins_.clear();
+    removed_driver_pins_.clear();
+    level_drivers_valid_ = false;
     sta_->clear();
     db_->clear();
 }
@@ -2650,6 +3043,16 @@ DatabaseHandler::sta() const
 }
 float
 DatabaseHandler::maxLoad(LibraryCell* cell)
+{
+    auto attributes = cellAttributes(cell);
+    if (attributes)
+    {
+        return attributes->max_load;
+    }
+    return outputMaxLoad(cell);
+}
+float
+DatabaseHandler::outputMaxLoad(LibraryCell* cell) const
 {
     sta::LibertyCellPortIterator itr(cell);
     while (itr.hasNext())
@@ -2722,10 +3125,25 @@ DatabaseHandler::isSingleOutputCombinational(Instance* inst) const
 bool
 DatabaseHandler::isBuffer(LibraryCell* cell) const
 {
+    auto attributes = cellAttributes(cell);
+    if (attributes)
+    {
+        return attributes->is_buffer;
+    }
     return cell->isBuffer();
 }
 bool
 DatabaseHandler::isInverter(LibraryCell* cell) const
+{
+    auto attributes = cellAttributes(cell);
+    if (attributes)
+    {
+        return attributes->is_inverter;
+    }
+    return inverterFunction(cell);
+}
+bool
+DatabaseHandler::inverterFunction(LibraryCell* cell) const
 {
     auto out_pins = libraryOutputPins(cell);
     return isSingleOutputCombinational(cell) && out_pins[0]->function() &&
@@ -2767,10 +3185,13 @@ DatabaseHandler::replaceInstance(Instance* inst, LibraryCell* cell)
         auto db_lib_cell  = db_->findMaster(current_name.c_str());
         if (db_lib_cell)
         {
+            markDirty(inst);
             auto db_inst     = network()->staToDb(inst);
             auto db_inst_lib = db_inst->getMaster();
             auto sta_cell    = network()->dbToSta(db_lib_cell);
             sta_->replaceCell(inst, sta_cell);
+            connectivity_.invalidate(inst);
+            level_order_stale_ = true;
         }
     }
 }
@@ -2828,7 +3249,11 @@ DatabaseHandler::setWireRC(float res_per_micron, float cap_per_micron,
     res_per_micron_ = res_per_micron;
     cap_per_micron_ = cap_per_micron;
     has_wire_rc_    = true;
+    // Full extraction also picks up placement changes made outside the
+    // handler
+    steiner_trees_.clear();
     calculateParasitics();
+    dirty_nets_.clear();
     sta_->findDelays();
 }
 void
@@ -2846,6 +3271,13 @@ DatabaseHandler::setDontUseCallback(DontUseCallback dont_use_callback)
     dont_use_callback_ = dont_use_callback;
 }
 void
+DatabaseHandler::setCharacterizationCache(const std::string& path)
+{
+    saveCharacterizationCache();
+    characterization_path_ = path;
+    characterization_.clear();
+}
+void
 DatabaseHandler::setComputeParasiticsCallback(
     ComputeParasiticsCallback compute_parasitics_callback)
 {
@@ -3087,21 +3519,216 @@ DatabaseHandler::resetCache()
     capacitance_limits_initialized_ = false;
     fanout_limits_initialized_      = false;
     target_load_map_.clear();
+    buffer_delay_models_.clear();
+    nldm_arcs_.clear();
+    has_nldm_tables_ = false;
+    cell_ids_.clear();
+    cell_attributes_.clear();
+    has_cell_attributes_ = false;
+    compiled_functions_.clear();
+    liberty_hashes_.clear();
     resetLibraryMapping();
 }
 void
-DatabaseHandler::findTargetLoads()
+DatabaseHandler::beginConcurrentQueries(const std::vector<Net*>& nets)
 {
-    auto all_libs = allLibs();
-    findTargetLoads(&all_libs);
-    has_target_loads_ = true;
+    if (concurrent_queries_)
+    {
+        endConcurrentQueries();
+    }
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    if (!has_nldm_tables_)
+    {
+        compileNldmTables();
+    }
+    if (!has_cell_attributes_)
+    {
+        buildCellAttributes();
+    }
+    connectivity_.refresh();
+    sta_->ensureLevelized();
+    sta_->search()->findAllArrivals();
+    sta_->search()->findRequireds();
+    concurrent_res_per_micron_ = resistancePerMicron();
+    concurrent_cap_per_micron_ = capacitancePerMicron();
+    for (auto& net : nets)
+    {
+        for (auto& pin : pins(net))
+        {
+            if (isLoad(pin))
+            {
+                concurrent_required_[pin] = required(pin);
+            }
+        }
+    }
+    concurrent_generation_++;
+    concurrent_queries_ = true;
 }
-
-Vertex*
-DatabaseHandler::vertex(InstanceTerm* term) const
+void
+DatabaseHandler::endConcurrentQueries()
 {
-    Vertex *vertex, *bidirect_drvr_vertex;
-    sta_->graph()->pinVertices(term, vertex, bidirect_drvr_vertex);
+    concurrent_queries_ = false;
+    concurrent_required_.clear();
+    for (auto& calc : concurrent_delay_calcs_)
+    {
+        delete calc;
+    }
+    concurrent_delay_calcs_.clear();
+}
+void
+DatabaseHandler::buildConnectivity()
+{
+    connectivity_.build(network());
+}
+void
+DatabaseHandler::clearConnectivity()
+{
+    connectivity_.clear();
+}
+const ConnectivityView*
+DatabaseHandler::connectivity() const
+{
+    if (!connectivity_.built())
+    {
+        return nullptr;
+    }
+    connectivity_.refresh();
+    return &connectivity_;
+}
+bool
+DatabaseHandler::inConcurrentQueries() const
+{
+    return concurrent_queries_;
+}
+sta::ArcDelayCalc*
+DatabaseHandler::arcDelayCalc() const
+{
+    if (!concurrent_queries_)
+    {
+        return sta_->arcDelayCalc();
+    }
+    // Delay calculators keep the intermediate results as members, so each
+    // thread works on its own copy.
+    thread_local const DatabaseHandler* calc_owner      = nullptr;
+    thread_local size_t                 calc_generation = 0;
+    thread_local sta::ArcDelayCalc*     calc            = nullptr;
+    if (calc_owner != this || calc_generation != concurrent_generation_)
+    {
+        std::lock_guard<std::mutex> lock(concurrent_mutex_);
+        calc            = sta_->arcDelayCalc()->copy();
+        calc_owner      = this;
+        calc_generation = concurrent_generation_;
+        concurrent_delay_calcs_.push_back(calc);
+    }
+    return calc;
+}
+void
+DatabaseHandler::findTargetLoads()
+{
+    // The buffer models are sampled around the target loads, so they are
+    // only restored along with them
+    if (restoreTargetLoads())
+    {
+        has_target_loads_ = true;
+        if (restoreBufferModels())
+        {
+            return;
+        }
+    }
+    else
+    {
+        auto all_libs = allLibs();
+        findTargetLoads(&all_libs);
+        storeTargetLoads();
+        has_target_loads_ = true;
+    }
+    characterizeBufferModels();
+}
+void
+DatabaseHandler::characterizeBufferModels()
+{
+    // Uniform load breakpoints up to the larger of the cell load limit and a
+    // multiple of its target load; output slews are also sampled over input
+    // slews up to a multiple of the target slew.
+    const size_t load_steps        = 33;
+    const size_t input_slew_steps  = 9;
+    const float  target_load_scale = 4.0;
+    const float  target_slew_scale = 8.0;
+
+    buffer_delay_models_.clear();
+    auto cells     = bufferCells();
+    auto inverters = inverterCells();
+    cells.insert(cells.end(), inverters.begin(), inverters.end());
+    std::vector<LibraryCharacterization::BufferModel> stored_models;
+
+    float max_input_slew =
+        target_slew_scale * std::max(target_slews_[0], target_slews_[1]);
+    for (auto& cell : cells)
+    {
+        auto output_pin = bufferOutputPin(cell);
+        if (!output_pin)
+        {
+            continue;
+        }
+        float max_load = std::max(maxLoad(output_pin),
+                                  target_load_scale * targetLoad(cell));
+        if (max_load <= 0.0)
+        {
+            continue;
+        }
+        // The whole grid goes through the compiled tables in two batches
+        std::vector<float> loads(load_steps);
+        std::vector<float> grid_loads(input_slew_steps * load_steps);
+        std::vector<float> grid_slews(input_slew_steps * load_steps);
+        for (size_t i = 0; i < load_steps; i++)
+        {
+            loads[i] = max_load * i / (load_steps - 1);
+            for (size_t j = 0; j < input_slew_steps; j++)
+            {
+                grid_loads[j * load_steps + i] = loads[i];
+                grid_slews[j * load_steps + i] =
+                    max_input_slew * j / (input_slew_steps - 1);
+            }
+        }
+        std::vector<float> delays, output_slews;
+        gateDelays(output_pin, loads, delays);
+        slews(output_pin, grid_loads, grid_slews, output_slews);
+        BufferDelayModel model(max_load, delays, max_input_slew,
+                               input_slew_steps, output_slews);
+#ifndef NDEBUG
+        // Segment midpoints carry the largest interpolation error
+        const float tolerance = 0.02;
+        for (size_t i = 0; i + 1 < load_steps; i++)
+        {
+            float load  = max_load * (i + 0.5) / (load_steps - 1);
+            float exact = gateDelay(output_pin, load);
+            if (std::abs(model.delay(load) - exact) >
+                tolerance * std::abs(exact))
+            {
+                PSN_LOG_WARN("Buffer delay model of {} is off by {} at load {}",
+                             cell->name(), model.delay(load) - exact, load);
+                break;
+            }
+        }
+#endif
+        buffer_delay_models_[cell] = model;
+        stored_models.push_back({characterizedName(cell), max_load,
+                                 max_input_slew, input_slew_steps,
+                                 std::move(delays), std::move(output_slews)});
+    }
+    PSN_LOG_DEBUG("Characterized {} buffer delay models",
+                  buffer_delay_models_.size());
+    storeBufferModels(std::move(stored_models));
+}
+
+Vertex*
+DatabaseHandler::vertex(InstanceTerm* term) const
+{
+    Vertex *vertex, *bidirect_drvr_vertex;
+    sta_->graph()->pinVertices(term, vertex, bidirect_drvr_vertex);
     return vertex;
 }
 
@@ -3115,7 +3742,61 @@ int
 DatabaseHandler::evaluateFunctionExpression(
     LibraryTerm* term, std::unordered_map<LibraryTerm*, int>& inputs) const
 {
-    return evaluateFunctionExpression(term->function(), inputs);
+    auto compiled = compiledFunction(term);
+    if (!compiled)
+    {
+        return evaluateFunctionExpression(term->function(), inputs);
+    }
+    // Every lane holds the same assignment, -1 if a port the function reads
+    // is not assigned
+    std::vector<uint64_t> values(compiled->variableCount(), 0);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        if (!compiled->dependsOn(i))
+        {
+            continue;
+        }
+        auto itr = inputs.find(compiled->variable(i));
+        if (itr == inputs.end())
+        {
+            return -1;
+        }
+        values[i] = itr->second ? ~0ULL : 0;
+    }
+    return compiled->evaluate(values.data()) & 1;
+}
+int
+DatabaseHandler::cofactorValue(InstanceTerm* term, LibraryTerm* input,
+                               bool value) const
+{
+    auto compiled = compiledFunction(libraryPin(term));
+    if (!compiled)
+    {
+        return -1;
+    }
+    int index = compiled->variableIndex(input);
+    if (index < 0)
+    {
+        return -1;
+    }
+    return compiled->constantCofactor(index, value);
+}
+const CompiledFunction*
+DatabaseHandler::compiledFunction(LibraryTerm* port) const
+{
+    auto itr = compiled_functions_.find(port);
+    if (itr == compiled_functions_.end())
+    {
+        CompiledFunction compiled;
+        if (port->function())
+        {
+            compiled =
+                CompiledFunction(port->function(),
+                                 libraryInputPins(port->libertyCell()));
+        }
+        itr = compiled_functions_.emplace(port, std::move(compiled)).first;
+    }
+    return itr->second.valid() ? &itr->second : nullptr;
 }
 int
 DatabaseHandler::evaluateFunctionExpression(
@@ -3237,6 +3918,10 @@ void
 DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
 {
     // TODO Support include buffer slews
+    if (restoreBufferPenalties(include_inverting))
+    {
+        return;
+    }
     auto all_libs = allLibs();
     buffer_inverter_seq_.clear();
     inverting_buffer_.clear();
@@ -3279,6 +3964,7 @@ DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
     penalty_cache_.clear();
     if (!buffer_inverter_seq_.size())
     {
+        storeBufferPenalties(include_inverting);
         return;
     }
     auto first_cell = buffer_inverter_seq_[0];
@@ -3323,6 +4009,7 @@ DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
             buffer_penalty_map_[buffer_inverter_seq_[i]] = min_penalty;
         }
     }
+    storeBufferPenalties(include_inverting);
 }
 InstanceTerm*
 DatabaseHandler::largestLoadCapacitancePin(Instance* cell)
@@ -3430,6 +4117,11 @@ DatabaseHandler::buildLibraryMappings(int                        max_length,
                                       std::vector<LibraryCell*>& inverter_lib)
 {
     resetLibraryMapping();
+    if (restoreLibraryMappings(max_length))
+    {
+        has_library_cell_mappings_ = true;
+        return;
+    }
     std::unordered_map<LibraryCell*, std::bitset<64>> truth_tables_sim;
 
     std::unordered_map<sta::FuncExpr*, std::bitset<64>> function_cache;
@@ -3684,6 +4376,7 @@ DatabaseHandler::buildLibraryMappings(int                        max_length,
     }
 
     has_library_cell_mappings_ = true;
+    storeLibraryMappings(max_length);
 }
 int
 DatabaseHandler::computeTruthTable(LibraryCell* lib_cell)
@@ -3693,6 +4386,15 @@ DatabaseHandler::computeTruthTable(LibraryCell* lib_cell)
     auto           input_pins  = libraryInputPins(lib_cell);
     auto           output_pin  = output_pins[0];
     sta::FuncExpr* output_func = output_pin->function();
+    // Minterm i assigns bit (n - j - 1) of i to input j, so the first input
+    // is the most significant variable of the compiled function.
+    std::vector<LibraryTerm*> variables(input_pins.rbegin(),
+                                        input_pins.rend());
+    CompiledFunction          compiled(output_func, variables);
+    if (compiled.valid())
+    {
+        return static_cast<int>(compiled.truthTable()[0]);
+    }
     for (int i = 0; i < std::pow(2, input_pins.size()); ++i)
     {
         std::unordered_map<LibraryTerm*, int> sim_vals;
@@ -3715,125 +4417,567 @@ DatabaseHandler::resetLibraryMapping()
     truth_tables_.clear();
 }
 
-/* The following is borrowed from James Cherry's Resizer Code */
-
-// Find a target slew for the libraries and then
-// a target load for each cell that gives the target slew.
-void
-DatabaseHandler::findTargetLoads(std::vector<Liberty*>* resize_libs)
+bool
+DatabaseHandler::characterizationKey(uint64_t& key)
 {
-    // Find target slew across all buffers in the libraries.
-    findBufferTargetSlews(resize_libs);
-    for (auto lib : *resize_libs)
-        findTargetLoads(lib, target_slews_);
+    key = LibraryCharacterization::hash(nullptr, 0);
+    for (auto& lib : allLibs())
+    {
+        std::string lib_name = lib->name();
+        std::string filename = lib->filename();
+        auto        itr      = liberty_hashes_.find(filename);
+        if (itr == liberty_hashes_.end())
+        {
+            uint64_t file_hash = LibraryCharacterization::hash(nullptr, 0);
+            if (!LibraryCharacterization::hashFile(filename, file_hash))
+            {
+                PSN_LOG_WARN("Cannot read {} to key the characterization "
+                             "cache",
+                             filename);
+                return false;
+            }
+            itr = liberty_hashes_.emplace(filename, file_hash).first;
+        }
+        key = LibraryCharacterization::hash(lib_name.c_str(),
+                                            lib_name.size() + 1, key);
+        key = LibraryCharacterization::hash(&itr->second, sizeof(itr->second),
+                                            key);
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
+        {
+            auto cell = cell_iter.next();
+            if (dontUse(cell))
+            {
+                std::string cell_name = cell->name();
+                key = LibraryCharacterization::hash(cell_name.c_str(),
+                                                    cell_name.size() + 1, key);
+            }
+        }
+    }
+    return true;
 }
-
-float
-DatabaseHandler::targetLoad(LibraryCell* cell)
+// Makes characterization_ hold the entries of the loaded libraries, reading
+// the cache file when they changed. False if caching is off.
+bool
+DatabaseHandler::loadCharacterization()
 {
-    if (!has_target_loads_)
+    uint64_t key;
+    if (characterization_path_.empty() || !characterizationKey(key))
     {
-        findTargetLoads();
+        return false;
     }
-    if (target_load_map_.count(cell))
+    if (characterization_.key != key)
     {
-        return target_load_map_[cell];
+        // Pending results belong to the previous libraries
+        saveCharacterizationCache();
+        if (characterization_.read(characterization_path_, key))
+        {
+            PSN_LOG_DEBUG("Loaded library characterization from {}",
+                          characterization_path_);
+        }
+        else
+        {
+            characterization_.clear();
+            characterization_.key = key;
+        }
     }
-    return 0.0;
+    return true;
 }
-
-float
-DatabaseHandler::coreArea() const
+void
+DatabaseHandler::saveCharacterizationCache()
 {
-    auto block = top();
-    Rect core;
-    block->getCoreArea(core);
-    return dbuToMeters(core.dx()) * dbuToMeters(core.dy());
+    if (!characterization_dirty_ || characterization_path_.empty())
+    {
+        return;
+    }
+    characterization_dirty_ = false;
+    if (!characterization_.write(characterization_path_))
+    {
+        PSN_LOG_WARN("Cannot write the characterization cache {}",
+                     characterization_path_);
+    }
 }
-
-bool
-DatabaseHandler::maximumUtilizationViolation() const
+std::string
+DatabaseHandler::characterizedName(LibraryCell* cell) const
 {
-    return sta::fuzzyGreaterEqual(area(), maximumArea());
+    return std::string(cell->libertyLibrary()->name()) + "/" + cell->name();
 }
-void
-DatabaseHandler::setMaximumArea(float area)
+std::unordered_map<std::string, LibraryCell*>
+DatabaseHandler::characterizedCells() const
 {
-    maximum_area_       = area;
-    maximum_area_valid_ = true;
+    std::unordered_map<std::string, LibraryCell*> cells;
+    for (auto& lib : allLibs())
+    {
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
+        {
+            auto cell = cell_iter.next();
+            cells[characterizedName(cell)] = cell;
+        }
+    }
+    return cells;
 }
-
-void
-DatabaseHandler::setMaximumArea(MaxAreaCallback maximum_area_callback)
+bool
+DatabaseHandler::restoreTargetLoads()
 {
-    maximum_area_callback_ = maximum_area_callback;
-    maximum_area_valid_    = true;
+    if (!loadCharacterization() || !characterization_.has_target_loads)
+    {
+        return false;
+    }
+    auto                                    cells = characterizedCells();
+    std::unordered_map<LibraryCell*, float> loads;
+    for (auto& load : characterization_.target_loads)
+    {
+        auto itr = cells.find(load.first);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        loads[itr->second] = load.second;
+    }
+    for (auto rf : sta::RiseFall::rangeIndex())
+    {
+        target_slews_[rf] = characterization_.target_slews[rf];
+    }
+    target_load_map_ = std::move(loads);
+    return true;
 }
 void
-DatabaseHandler::setUpdateDesignArea(
-    UpdateDesignAreaCallback update_design_area_callback)
+DatabaseHandler::storeTargetLoads()
 {
-    update_design_area_callback_ = update_design_area_callback;
+    if (!loadCharacterization())
+    {
+        return;
+    }
+    characterization_.has_target_loads = true;
+    for (auto rf : sta::RiseFall::rangeIndex())
+    {
+        characterization_.target_slews[rf] = target_slews_[rf];
+    }
+    characterization_.target_loads.clear();
+    for (auto& load : target_load_map_)
+    {
+        characterization_.target_loads.push_back(
+            {characterizedName(load.first), load.second});
+    }
+    characterization_dirty_ = true;
 }
-void
-DatabaseHandler::notifyDesignAreaChanged(float new_area)
+bool
+DatabaseHandler::restoreBufferModels()
 {
-    if (update_design_area_callback_ != nullptr)
+    if (!loadCharacterization() || !characterization_.has_buffer_models)
     {
-        update_design_area_callback_(new_area);
+        return false;
+    }
+    std::unordered_map<LibraryCell*, BufferDelayModel> models;
+
+    auto cells = characterizedCells();
+    for (auto& model : characterization_.buffer_models)
+    {
+        auto itr = cells.find(model.cell);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        models[itr->second] =
+            BufferDelayModel(model.max_load, model.delays, model.max_input_slew,
+                             model.input_slew_steps, model.slews);
     }
+    buffer_delay_models_ = std::move(models);
+    return true;
 }
 void
-DatabaseHandler::notifyDesignAreaChanged()
+DatabaseHandler::storeBufferModels(
+    std::vector<LibraryCharacterization::BufferModel> models)
 {
-    if (update_design_area_callback_ != nullptr)
+    if (!loadCharacterization())
     {
-        update_design_area_callback_(area());
+        return;
     }
+    characterization_.has_buffer_models = true;
+    characterization_.buffer_models     = std::move(models);
+    characterization_dirty_             = true;
 }
 bool
-DatabaseHandler::hasMaximumArea() const
+DatabaseHandler::restoreBufferClusters(
+    float cluster_threshold, bool find_superior, bool include_inverting,
+    std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>& clusters)
 {
-    if (maximum_area_callback_ != nullptr)
+    if (!loadCharacterization() || !characterization_.has_buffer_clusters ||
+        characterization_.cluster_threshold != cluster_threshold ||
+        characterization_.find_superior != find_superior ||
+        characterization_.cluster_inverting != include_inverting)
     {
-        return maximum_area_callback_();
+        return false;
     }
-    return maximum_area_valid_;
-}
-
-float
-DatabaseHandler::maximumArea() const
-{
-    if (!maximum_area_valid_)
+    auto                      cells = characterizedCells();
+    std::vector<LibraryCell*> buffers, inverters;
+    for (auto& name : characterization_.cluster_buffers)
     {
-        PSN_LOG_WARN("Maximum area is not set or invalid");
+        auto itr = cells.find(name);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        buffers.push_back(itr->second);
     }
-    if (maximum_area_callback_)
+    for (auto& name : characterization_.cluster_inverters)
     {
-        return maximum_area_callback_();
+        auto itr = cells.find(name);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        inverters.push_back(itr->second);
     }
-    return maximum_area_;
+    clusters.first  = std::move(buffers);
+    clusters.second = std::move(inverters);
+    return true;
 }
-
-float
-DatabaseHandler::gateDelay(Instance* inst, InstanceTerm* to, float in_slew,
-                           LibraryTerm* from, float* drvr_slew, int rise_fall)
+void
+DatabaseHandler::storeBufferClusters(
+    float cluster_threshold, bool find_superior, bool include_inverting,
+    const std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>&
+        clusters)
 {
-    return gateDelay(libraryCell(inst), to, in_slew, from, drvr_slew,
-                     rise_fall);
+    if (!loadCharacterization())
+    {
+        return;
+    }
+    characterization_.has_buffer_clusters = true;
+    characterization_.cluster_threshold   = cluster_threshold;
+    characterization_.find_superior       = find_superior;
+    characterization_.cluster_inverting   = include_inverting;
+    characterization_.cluster_buffers.clear();
+    characterization_.cluster_inverters.clear();
+    for (auto& buf : clusters.first)
+    {
+        characterization_.cluster_buffers.push_back(characterizedName(buf));
+    }
+    for (auto& inv : clusters.second)
+    {
+        characterization_.cluster_inverters.push_back(characterizedName(inv));
+    }
+    characterization_dirty_ = true;
 }
-
-float
-DatabaseHandler::gateDelay(LibraryCell* lib_cell, InstanceTerm* to,
-                           float in_slew, LibraryTerm* from, float* drvr_slew,
-                           int rise_fall)
+bool
+DatabaseHandler::restoreBufferPenalties(bool include_inverting)
 {
-    sta::ArcDelay                        max = -sta::INF;
-    sta::LibertyCellTimingArcSetIterator itr(lib_cell);
-    while (itr.hasNext())
+    if (!loadCharacterization() || !characterization_.has_buffer_penalties ||
+        characterization_.include_inverting != include_inverting)
     {
-        sta::TimingArcSet* arc_set = itr.next();
-        if (arc_set->to() == libraryPin(to))
+        return false;
+    }
+    auto                                    cells = characterizedCells();
+    std::vector<LibraryCell*>               sequence;
+    std::unordered_set<LibraryCell*>        inverting;
+    std::unordered_map<LibraryCell*, float> penalties;
+    std::unordered_map<LibraryCell*, float> inverting_penalties;
+    for (auto& name : characterization_.buffer_sequence)
+    {
+        auto itr = cells.find(name);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        sequence.push_back(itr->second);
+    }
+    for (auto& name : characterization_.inverting_buffers)
+    {
+        auto itr = cells.find(name);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        inverting.insert(itr->second);
+    }
+    for (auto& penalty : characterization_.buffer_penalties)
+    {
+        auto itr = cells.find(penalty.first);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        penalties[itr->second] = penalty.second;
+    }
+    for (auto& penalty : characterization_.inverting_penalties)
+    {
+        auto itr = cells.find(penalty.first);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        inverting_penalties[itr->second] = penalty.second;
+    }
+    buffer_inverter_seq_ = std::move(sequence);
+    inverting_buffer_    = std::move(inverting);
+    non_inverting_buffer_.clear();
+    for (auto& buf : buffer_inverter_seq_)
+    {
+        if (!inverting_buffer_.count(buf))
+        {
+            non_inverting_buffer_.insert(buf);
+        }
+    }
+    buffer_penalty_map_           = std::move(penalties);
+    inverting_buffer_penalty_map_ = std::move(inverting_penalties);
+    penalty_cache_.clear();
+    has_buffer_inverter_seq_ = true;
+    return true;
+}
+void
+DatabaseHandler::storeBufferPenalties(bool include_inverting)
+{
+    if (!loadCharacterization())
+    {
+        return;
+    }
+    characterization_.has_buffer_penalties = true;
+    characterization_.include_inverting    = include_inverting;
+    characterization_.buffer_sequence.clear();
+    characterization_.inverting_buffers.clear();
+    characterization_.buffer_penalties.clear();
+    characterization_.inverting_penalties.clear();
+    for (auto& buf : buffer_inverter_seq_)
+    {
+        characterization_.buffer_sequence.push_back(characterizedName(buf));
+    }
+    for (auto& buf : inverting_buffer_)
+    {
+        characterization_.inverting_buffers.push_back(characterizedName(buf));
+    }
+    for (auto& penalty : buffer_penalty_map_)
+    {
+        characterization_.buffer_penalties.push_back(
+            {characterizedName(penalty.first), penalty.second});
+    }
+    for (auto& penalty : inverting_buffer_penalty_map_)
+    {
+        characterization_.inverting_penalties.push_back(
+            {characterizedName(penalty.first), penalty.second});
+    }
+    characterization_dirty_ = true;
+}
+static std::shared_ptr<LibraryCellMappingNode>
+restoreMappingNode(const LibraryCharacterization::MappingNode& node,
+                   LibraryCellMappingNode*                     parent)
+{
+    auto restored = std::make_shared<LibraryCellMappingNode>(
+        node.name, node.id, parent, node.terminal, node.recurring,
+        node.is_buffer, node.is_inverter, node.level);
+    restored->setSelf(restored);
+    for (auto& child : node.children)
+    {
+        restored->children()[child.id] =
+            restoreMappingNode(child, restored.get());
+    }
+    return restored;
+}
+static LibraryCharacterization::MappingNode
+storeMappingNode(LibraryCellMappingNode& node)
+{
+    LibraryCharacterization::MappingNode stored;
+    stored.name        = node.name();
+    stored.id          = node.id();
+    stored.terminal    = node.terminal();
+    stored.recurring   = node.recurring();
+    stored.is_buffer   = node.isBuffer();
+    stored.is_inverter = node.isInverter();
+    stored.level       = node.level();
+    for (auto& child : node.children())
+    {
+        stored.children.push_back(storeMappingNode(*child.second));
+    }
+    return stored;
+}
+bool
+DatabaseHandler::restoreLibraryMappings(int max_length)
+{
+    if (!loadCharacterization() || !characterization_.has_library_mappings ||
+        characterization_.mapping_length != max_length)
+    {
+        return false;
+    }
+    auto                                          cells = characterizedCells();
+    std::unordered_map<LibraryCell*, std::string> truth_tables;
+    for (auto& table : characterization_.truth_tables)
+    {
+        auto itr = cells.find(table.first);
+        if (itr == cells.end())
+        {
+            return false;
+        }
+        truth_tables[itr->second] = table.second;
+    }
+    truth_tables_ = std::move(truth_tables);
+    for (auto& table : truth_tables_)
+    {
+        if (!table.second.empty())
+        {
+            function_to_cell_[table.second].insert(table.first);
+        }
+    }
+    for (auto& stored : characterization_.mappings)
+    {
+        std::string id      = stored.id;
+        auto        mapping = std::make_shared<LibraryCellMapping>(id);
+        for (auto& root : stored.roots)
+        {
+            mapping->mappings()->insert(
+                {root.id, restoreMappingNode(root, nullptr)});
+        }
+        library_cell_mappings_[id] = mapping;
+    }
+    return true;
+}
+void
+DatabaseHandler::storeLibraryMappings(int max_length)
+{
+    if (!loadCharacterization())
+    {
+        return;
+    }
+    characterization_.has_library_mappings = true;
+    characterization_.mapping_length       = max_length;
+    characterization_.truth_tables.clear();
+    characterization_.mappings.clear();
+    for (auto& table : truth_tables_)
+    {
+        characterization_.truth_tables.push_back(
+            {characterizedName(table.first), table.second});
+    }
+    for (auto& mapping : library_cell_mappings_)
+    {
+        LibraryCharacterization::Mapping stored;
+        stored.id = mapping.first;
+        for (auto& root : *mapping.second->mappings())
+        {
+            stored.roots.push_back(storeMappingNode(*root.second));
+        }
+        characterization_.mappings.push_back(std::move(stored));
+    }
+    characterization_dirty_ = true;
+}
+
+/* The following is borrowed from James Cherry's Resizer Code */
+
+// Find a target slew for the libraries and then
+// a target load for each cell that gives the target slew.
+void
+DatabaseHandler::findTargetLoads(std::vector<Liberty*>* resize_libs)
+{
+    // Find target slew across all buffers in the libraries.
+    findBufferTargetSlews(resize_libs);
+    for (auto lib : *resize_libs)
+        findTargetLoads(lib, target_slews_);
+}
+
+float
+DatabaseHandler::targetLoad(LibraryCell* cell)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    if (target_load_map_.count(cell))
+    {
+        return target_load_map_[cell];
+    }
+    return 0.0;
+}
+
+float
+DatabaseHandler::coreArea() const
+{
+    auto block = top();
+    Rect core;
+    block->getCoreArea(core);
+    return dbuToMeters(core.dx()) * dbuToMeters(core.dy());
+}
+
+bool
+DatabaseHandler::maximumUtilizationViolation() const
+{
+    return sta::fuzzyGreaterEqual(area(), maximumArea());
+}
+void
+DatabaseHandler::setMaximumArea(float area)
+{
+    maximum_area_       = area;
+    maximum_area_valid_ = true;
+}
+
+void
+DatabaseHandler::setMaximumArea(MaxAreaCallback maximum_area_callback)
+{
+    maximum_area_callback_ = maximum_area_callback;
+    maximum_area_valid_    = true;
+}
+void
+DatabaseHandler::setUpdateDesignArea(
+    UpdateDesignAreaCallback update_design_area_callback)
+{
+    update_design_area_callback_ = update_design_area_callback;
+}
+void
+DatabaseHandler::notifyDesignAreaChanged(float new_area)
+{
+    if (update_design_area_callback_ != nullptr)
+    {
+        update_design_area_callback_(new_area);
+    }
+}
+void
+DatabaseHandler::notifyDesignAreaChanged()
+{
+    if (update_design_area_callback_ != nullptr)
+    {
+        update_design_area_callback_(area());
+    }
+}
+bool
+DatabaseHandler::hasMaximumArea() const
+{
+    if (maximum_area_callback_ != nullptr)
+    {
+        return maximum_area_callback_();
+    }
+    return maximum_area_valid_;
+}
+
+float
+DatabaseHandler::maximumArea() const
+{
+    if (!maximum_area_valid_)
+    {
+        PSN_LOG_WARN("Maximum area is not set or invalid");
+    }
+    if (maximum_area_callback_)
+    {
+        return maximum_area_callback_();
+    }
+    return maximum_area_;
+}
+
+float
+DatabaseHandler::gateDelay(Instance* inst, InstanceTerm* to, float in_slew,
+                           LibraryTerm* from, float* drvr_slew, int rise_fall)
+{
+    return gateDelay(libraryCell(inst), to, in_slew, from, drvr_slew,
+                     rise_fall);
+}
+
+float
+DatabaseHandler::gateDelay(LibraryCell* lib_cell, InstanceTerm* to,
+                           float in_slew, LibraryTerm* from, float* drvr_slew,
+                           int rise_fall)
+{
+    sta::ArcDelay                        max = -sta::INF;
+    sta::LibertyCellTimingArcSetIterator itr(lib_cell);
+    while (itr.hasNext())
+    {
+        sta::TimingArcSet* arc_set = itr.next();
+        if (arc_set->to() == libraryPin(to))
         {
             sta::TimingArcSetArcIterator arc_it(arc_set);
             while (arc_it.hasNext())
@@ -3855,7 +4999,7 @@ DatabaseHandler::gateDelay(LibraryCell* lib_cell, InstanceTerm* to,
                         sta::Slew*    slew = drvr_slew ? drvr_slew : &tmp_slew;
                         in_slew =
                             target_slews_[arc->toTrans()->asRiseFall()->index()];
-                        sta_->arcDelayCalc()->gateDelay(
+                        arcDelayCalc()->gateDelay(
                             lib_cell, arc, in_slew, load_cap, nullptr, 0.0,
                             pvt_, dcalc_ap_, gate_delay, *slew);
                         max = std::max(max, gate_delay);
@@ -3942,27 +5086,8 @@ DatabaseHandler::findTargetLoad(LibraryCell* cell, sta::TimingArc* arc,
 std::set<Net*>
 DatabaseHandler::clockNets() const
 {
-    std::set<Net*>            nets;
-    sta::ClkArrivalSearchPred srch_pred(sta_);
-    sta::BfsFwdIterator       bfs(sta::BfsIndex::other, &srch_pred, sta_);
-    sta::PinSet               clk_pins;
-    sta_->search()->findClkVertexPins(clk_pins);
-    for (auto pin : clk_pins)
-    {
-        Vertex *vert, *bi_vert;
-        network()->graph()->pinVertices(pin, vert, bi_vert);
-        bfs.enqueue(vert);
-        if (bi_vert)
-            bfs.enqueue(bi_vert);
-    }
-    while (bfs.hasNext())
-    {
-        auto vertex = bfs.next();
-        auto pin    = vertex->pin();
-        Net* net    = network()->net(pin);
-        nets.insert(net);
-        bfs.enqueueAdjacentVertices(vertex);
-    }
+    std::set<Net*> nets;
+    forEachClockNet([&](Net* net) { nets.insert(net); });
     return nets;
 }
 void
@@ -4036,6 +5161,19 @@ DatabaseHandler::gateDelay(LibraryTerm* out_port, float load_cap,
     {
         findTargetLoads();
     }
+    auto nldm_arcs = nldmArcs(out_port);
+    if (nldm_arcs)
+    {
+        float max_delay = -sta::INF;
+        for (auto& arc : *nldm_arcs)
+        {
+            float in_slew =
+                tr_slew ? *tr_slew : target_slews_[arc.input_transition];
+            max_delay =
+                std::max(max_delay, arc.delay.lookup(in_slew, load_cap));
+        }
+        return max_delay;
+    }
     auto cell = out_port->libertyCell();
     // Max rise/fall delays.
     sta::ArcDelay                        max_delay = -sta::INF;
@@ -4054,7 +5192,7 @@ DatabaseHandler::gateDelay(LibraryTerm* out_port, float load_cap,
                     tr_slew ? *tr_slew : target_slews_[in_rf->index()];
                 sta::ArcDelay gate_delay;
                 sta::Slew     drvr_slew;
-                sta_->arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
+                arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
                                                 nullptr, 0.0, pvt_, dcalc_ap_,
                                                 gate_delay, drvr_slew);
                 max_delay = std::max(max_delay, gate_delay);
@@ -4063,14 +5201,189 @@ DatabaseHandler::gateDelay(LibraryTerm* out_port, float load_cap,
     }
     return max_delay;
 }
+void
+DatabaseHandler::gateDelays(LibraryTerm*              out_port,
+                            const std::vector<float>& load_caps,
+                            std::vector<float>& delays, float* tr_slew)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto nldm_arcs = nldmArcs(out_port);
+    delays.resize(load_caps.size());
+    if (!nldm_arcs)
+    {
+        for (size_t i = 0; i < load_caps.size(); i++)
+        {
+            delays[i] = gateDelay(out_port, load_caps[i], tr_slew);
+        }
+        return;
+    }
+    std::fill(delays.begin(), delays.end(), -sta::INF);
+    std::vector<float> in_slews(load_caps.size());
+    std::vector<float> arc_delays(load_caps.size());
+    for (auto& arc : *nldm_arcs)
+    {
+        std::fill(in_slews.begin(), in_slews.end(),
+                  tr_slew ? *tr_slew : target_slews_[arc.input_transition]);
+        arc.delay.lookup(in_slews.data(), load_caps.data(), arc_delays.data(),
+                         load_caps.size());
+        for (size_t i = 0; i < load_caps.size(); i++)
+        {
+            delays[i] = std::max(delays[i], arc_delays[i]);
+        }
+    }
+}
+
+// Samples the table at its breakpoints through OpenSTA so that the library
+// scaling is included, the slew axis is made the first one
+static bool
+compileNldmTable(sta::LibertyCell* cell, const sta::Pvt* pvt,
+                 const sta::TableModel* model, NldmTable& table)
+{
+    if (!model || model->axis3())
+    {
+        return false;
+    }
+    auto axis_values = [](const sta::TableAxis* axis) {
+        std::vector<float> values;
+        for (size_t i = 0; axis && i < axis->size(); i++)
+        {
+            values.push_back(axis->axisValue(i));
+        }
+        if (values.empty())
+        {
+            values.push_back(0.0); // Table is constant along the axis
+        }
+        return values;
+    };
+    auto axis1   = model->axis1();
+    auto values1 = axis_values(axis1);
+    auto values2 = axis_values(model->axis2());
+    // Liberty templates may list the load axis first
+    bool load_first =
+        axis1 && axis1->variable() ==
+                     sta::TableAxisVariable::total_output_net_capacitance;
+    auto& slew_axis = load_first ? values2 : values1;
+    auto& load_axis = load_first ? values1 : values2;
+
+    std::vector<float> values(slew_axis.size() * load_axis.size());
+    for (size_t i = 0; i < values1.size(); i++)
+    {
+        for (size_t j = 0; j < values2.size(); j++)
+        {
+            size_t slew_index = load_first ? j : i;
+            size_t load_index = load_first ? i : j;
+            values[slew_index * load_axis.size() + load_index] =
+                model->findValue(cell->libertyLibrary(), cell, pvt,
+                                 values1[i], values2[j], 0.0);
+        }
+    }
+    table = NldmTable(slew_axis, load_axis, values);
+    return table.valid();
+}
+void
+DatabaseHandler::compileNldmTables()
+{
+    nldm_arcs_.clear();
+    std::unordered_set<LibraryTerm*> uncompiled_ports;
+    for (auto& lib : allLibs())
+    {
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
+        {
+            auto                                 cell = cell_iter.next();
+            sta::LibertyCellTimingArcSetIterator set_iter(cell);
+            while (set_iter.hasNext())
+            {
+                sta::TimingArcSet*           arc_set = set_iter.next();
+                sta::TimingArcSetArcIterator arc_iter(arc_set);
+                while (arc_iter.hasNext())
+                {
+                    sta::TimingArc*      arc   = arc_iter.next();
+                    sta::RiseFall*       in_rf = arc->fromTrans()->asRiseFall();
+                    sta::GateTableModel* model =
+                        dynamic_cast<sta::GateTableModel*>(arc->model());
+                    NldmArc nldm_arc;
+                    if (!in_rf || !model ||
+                        !compileNldmTable(cell, pvt_, model->delayModel(),
+                                          nldm_arc.delay) ||
+                        !compileNldmTable(cell, pvt_, model->slewModel(),
+                                          nldm_arc.slew))
+                    {
+                        uncompiled_ports.insert(arc_set->to());
+                        continue;
+                    }
+                    nldm_arc.input_transition = in_rf->index();
+                    nldm_arcs_[arc_set->to()].push_back(nldm_arc);
+                }
+            }
+        }
+    }
+    for (auto& port : uncompiled_ports)
+    {
+        nldm_arcs_.erase(port);
+    }
+    has_nldm_tables_ = true;
+}
+const std::vector<DatabaseHandler::NldmArc>*
+DatabaseHandler::nldmArcs(LibraryTerm* out_port)
+{
+    if (!has_nldm_tables_)
+    {
+        compileNldmTables();
+    }
+    auto arcs_itr = nldm_arcs_.find(out_port);
+    return arcs_itr != nldm_arcs_.end() ? &arcs_itr->second : nullptr;
+}
 
 float
 DatabaseHandler::bufferDelay(psn::LibraryCell* buffer_cell, float load_cap)
 {
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto model_itr = buffer_delay_models_.find(buffer_cell);
+    if (model_itr != buffer_delay_models_.end())
+    {
+        return model_itr->second.delay(load_cap);
+    }
     psn::LibraryTerm *input, *output;
     buffer_cell->bufferPorts(input, output);
     return gateDelay(output, load_cap);
 }
+float
+DatabaseHandler::bufferSlew(psn::LibraryCell* buffer_cell, float load_cap,
+                            float input_slew)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto model_itr = buffer_delay_models_.find(buffer_cell);
+    if (model_itr != buffer_delay_models_.end() &&
+        model_itr->second.hasSlew(input_slew))
+    {
+        return model_itr->second.slew(load_cap, input_slew);
+    }
+    return slew(bufferOutputPin(buffer_cell), load_cap, &input_slew);
+}
+const BufferDelayModel*
+DatabaseHandler::bufferDelayModel(LibraryCell* buffer_cell)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto model_itr = buffer_delay_models_.find(buffer_cell);
+    if (model_itr != buffer_delay_models_.end())
+    {
+        return &model_itr->second;
+    }
+    return nullptr;
+}
 
 float
 DatabaseHandler::portCapacitance(const LibraryTerm* port, bool isMax) const
@@ -4085,6 +5398,11 @@ DatabaseHandler::portCapacitance(const LibraryTerm* port, bool isMax) const
 LibraryTerm*
 DatabaseHandler::bufferInputPin(LibraryCell* buffer_cell) const
 {
+    auto attributes = cellAttributes(buffer_cell);
+    if (attributes)
+    {
+        return attributes->buffer_input;
+    }
     LibraryTerm *input, *output;
     buffer_cell->bufferPorts(input, output);
     return input;
@@ -4092,10 +5410,25 @@ DatabaseHandler::bufferInputPin(LibraryCell* buffer_cell) const
 LibraryTerm*
 DatabaseHandler::bufferOutputPin(LibraryCell* buffer_cell) const
 {
+    auto attributes = cellAttributes(buffer_cell);
+    if (attributes)
+    {
+        return attributes->buffer_output;
+    }
     LibraryTerm *input, *output;
     buffer_cell->bufferPorts(input, output);
     return output;
 }
+float
+DatabaseHandler::driveResistance(LibraryCell* buffer_cell) const
+{
+    auto attributes = cellAttributes(buffer_cell);
+    if (attributes)
+    {
+        return attributes->drive_resistance;
+    }
+    return bufferOutputPin(buffer_cell)->driveResistance();
+}
 
 float
 DatabaseHandler::inverterInputCapacitance(LibraryCell* inv_cell)
@@ -4107,6 +5440,11 @@ DatabaseHandler::inverterInputCapacitance(LibraryCell* inv_cell)
 float
 DatabaseHandler::bufferInputCapacitance(LibraryCell* buffer_cell) const
 {
+    auto attributes = cellAttributes(buffer_cell);
+    if (attributes)
+    {
+        return attributes->buffer_input_capacitance;
+    }
     LibraryTerm *input, *output;
     buffer_cell->bufferPorts(input, output);
     return portCapacitance(input);
@@ -4156,9 +5494,59 @@ DatabaseHandler::findBufferTargetSlews(std::vector<Liberty*>* resize_libs)
 bool
 DatabaseHandler::dontUse(LibraryCell* cell) const
 {
-    return cell->dontUse() || dont_use_.count(cell) ||
+    auto attributes = cellAttributes(cell);
+    bool dont_use   = attributes ? attributes->dont_use
+                               : cell->dontUse() || dont_use_.count(cell);
+    return dont_use ||
            (dont_use_callback_ != nullptr && dont_use_callback_(cell));
 }
+void
+DatabaseHandler::buildCellAttributes() const
+{
+    cell_ids_.clear();
+    cell_attributes_.clear();
+    for (auto& lib : allLibs())
+    {
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
+        {
+            auto           cell = cell_iter.next();
+            CellAttributes attributes;
+            attributes.area     = masterArea(cell);
+            attributes.max_load = outputMaxLoad(cell);
+            cell->bufferPorts(attributes.buffer_input,
+                              attributes.buffer_output);
+            attributes.buffer_input_capacitance =
+                attributes.buffer_input
+                    ? portCapacitance(attributes.buffer_input)
+                    : 0.0;
+            attributes.drive_resistance =
+                attributes.buffer_output
+                    ? attributes.buffer_output->driveResistance()
+                    : 0.0;
+            attributes.is_buffer   = cell->isBuffer();
+            attributes.is_inverter = inverterFunction(cell);
+            attributes.dont_use    = cell->dontUse() || dont_use_.count(cell);
+            cell_ids_[cell]        = cell_attributes_.size();
+            cell_attributes_.push_back(attributes);
+        }
+    }
+    has_cell_attributes_ = true;
+}
+const DatabaseHandler::CellAttributes*
+DatabaseHandler::cellAttributes(const LibraryCell* cell) const
+{
+    if (!has_cell_attributes_)
+    {
+        buildCellAttributes();
+    }
+    auto itr = cell_ids_.find(cell);
+    if (itr == cell_ids_.end())
+    {
+        return nullptr;
+    }
+    return &cell_attributes_[itr->second];
+}
 bool
 DatabaseHandler::dontTouch(Instance* inst) const
 {
@@ -4232,14 +5620,83 @@ DatabaseHandler::findBufferTargetSlews(Liberty* library,
 void
 DatabaseHandler::calculateParasitics()
 {
-    for (auto& net : nets())
-    {
+    std::vector<Net*> signal_nets;
+    forEachNet([&](Net* net) {
         if (!isClock(net) && !network()->isPower(net) &&
             !network()->isGround(net))
+        {
+            signal_nets.push_back(net);
+        }
+    });
+    if (compute_parasitics_callback_ != nullptr)
+    {
+        for (auto& net : signal_nets)
+        {
+            calculateParasitics(net);
+        }
+        return;
+    }
+    SteinerTree::resetStatistics();
+    if (parasitics_threads_ <= 1)
+    {
+        for (auto& net : signal_nets)
         {
             calculateParasitics(net);
         }
     }
+    else
+    {
+        // Only the Steiner trees are built on the workers, the parasitics
+        // store is not thread-safe so the networks are reduced and committed
+        // serially
+        auto trees = steinerTrees(signal_nets);
+        for (size_t i = 0; i < signal_nets.size(); i++)
+        {
+            dirty_nets_.erase(signal_nets[i]);
+            commitParasitics(signal_nets[i], trees[i]);
+        }
+        PSN_LOG_DEBUG("Extracted {} nets on {} threads", signal_nets.size(),
+                      parasitics_threads_);
+    }
+    auto stats = SteinerTree::statistics();
+    if (stats.spanning_tree_nets)
+    {
+        // Lower quality trees, worth reporting
+        PSN_LOG_INFO("Steiner trees: {} Flute, {} spanning tree (maximum "
+                     "degree {}, Flute limit {})",
+                     stats.flute_nets, stats.spanning_tree_nets,
+                     stats.max_spanning_tree_degree,
+                     steiner_flute_degree_limit_);
+    }
+    else
+    {
+        PSN_LOG_DEBUG("Steiner trees: {} Flute", stats.flute_nets);
+    }
+}
+void
+DatabaseHandler::setParasiticsThreads(int threads)
+{
+    parasitics_threads_ = threads;
+}
+int
+DatabaseHandler::parasiticsThreads() const
+{
+    return parasitics_threads_;
+}
+void
+DatabaseHandler::setSteinerFluteDegreeLimit(int limit)
+{
+    if (limit != steiner_flute_degree_limit_)
+    {
+        std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+        steiner_trees_.clear();
+    }
+    steiner_flute_degree_limit_ = limit;
+}
+int
+DatabaseHandler::steinerFluteDegreeLimit() const
+{
+    return steiner_flute_degree_limit_;
 }
 bool
 DatabaseHandler::isClock(Net* net) const
@@ -4261,15 +5718,119 @@ DatabaseHandler::isClock(Net* net) const
     return false;
 }
 
+void
+DatabaseHandler::updateParasitics()
+{
+    float res_per_micron = resistancePerMicron();
+    float cap_per_micron = capacitancePerMicron();
+    if (res_per_micron != res_per_micron_ || cap_per_micron != cap_per_micron_)
+    {
+        // Wire RC changed, every net is stale
+        setWireRC(res_per_micron, cap_per_micron, false);
+        return;
+    }
+    auto dirty_nets = std::move(dirty_nets_);
+    dirty_nets_.clear();
+    for (auto& net : dirty_nets)
+    {
+        if (!isClock(net) && !network()->isPower(net) &&
+            !network()->isGround(net))
+        {
+            calculateParasitics(net);
+            auto driver = faninPin(net);
+            if (driver)
+            {
+                resetDelays(driver);
+            }
+        }
+    }
+    PSN_LOG_DEBUG("Updated parasitics of {} nets", dirty_nets.size());
+    sta_->findDelays();
+}
+void
+DatabaseHandler::markDirty(Net* net) const
+{
+    if (net)
+    {
+        dirty_nets_.insert(net);
+        std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+        steiner_trees_.erase(net);
+    }
+}
+std::shared_ptr<const SteinerTree>
+DatabaseHandler::steinerTree(Net* net)
+{
+    {
+        std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+        auto                        tree_it = steiner_trees_.find(net);
+        if (tree_it != steiner_trees_.end())
+        {
+            return tree_it->second;
+        }
+    }
+    // Built outside the lock so that concurrent queries run Flute in parallel
+    std::shared_ptr<const SteinerTree> tree = SteinerTree::create(net, psn_);
+    std::lock_guard<std::mutex>        lock(steiner_trees_mutex_);
+    steiner_trees_[net] = tree;
+    return tree;
+}
+std::vector<std::shared_ptr<const SteinerTree>>
+DatabaseHandler::steinerTrees(const std::vector<Net*>& nets)
+{
+    std::vector<std::shared_ptr<const SteinerTree>> trees(nets.size());
+    std::vector<Net*>                               missing_nets;
+    std::vector<size_t>                             missing_indices;
+    {
+        std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+        for (size_t i = 0; i < nets.size(); i++)
+        {
+            auto tree_it = steiner_trees_.find(nets[i]);
+            if (tree_it != steiner_trees_.end())
+            {
+                trees[i] = tree_it->second;
+            }
+            else
+            {
+                missing_nets.push_back(nets[i]);
+                missing_indices.push_back(i);
+            }
+        }
+    }
+    auto built_trees =
+        SteinerTree::createMany(missing_nets, psn_, 3, parasitics_threads_);
+    std::lock_guard<std::mutex> lock(steiner_trees_mutex_);
+    for (size_t i = 0; i < missing_nets.size(); i++)
+    {
+        std::shared_ptr<const SteinerTree> tree(std::move(built_trees[i]));
+        steiner_trees_[missing_nets[i]] = tree;
+        trees[missing_indices[i]]       = tree;
+    }
+    return trees;
+}
+void
+DatabaseHandler::markDirty(Instance* inst) const
+{
+    for (auto& pin : pins(inst))
+    {
+        markDirty(net(pin));
+    }
+}
+
 void
 DatabaseHandler::calculateParasitics(Net* net)
 {
+    dirty_nets_.erase(net);
     if (compute_parasitics_callback_ != nullptr)
     {
         compute_parasitics_callback_(net);
         return;
     }
-    auto tree = SteinerTree::create(net, psn_);
+    commitParasitics(net, steinerTree(net));
+}
+void
+DatabaseHandler::commitParasitics(
+    Net* net, const std::shared_ptr<const SteinerTree>& tree)
+{
     if (tree && tree->isPlaced())
     {
         sta::Parasitic* parasitic = sta_->parasitics()->makeParasiticNetwork(
@@ -4311,11 +5872,16 @@ DatabaseHandler::calculateParasitics(Net* net)
                                      sta::MinMax::max(), parasitics_ap_);
         sta_->parasitics()->deleteParasiticNetwork(net, parasitics_ap_);
     }
+    else
+    {
+        // Less than two pins or unplaced, drop the stale wire model
+        sta_->parasitics()->deleteParasitics(net, parasitics_ap_);
+    }
 }
 sta::ParasiticNode*
-DatabaseHandler::findParasiticNode(std::unique_ptr<SteinerTree>& tree,
-                                   sta::Parasitic* parasitic, const Net* net,
-                                   const InstanceTerm* pin, SteinerPoint pt)
+DatabaseHandler::findParasiticNode(
+    const std::shared_ptr<const SteinerTree>& tree, sta::Parasitic* parasitic,
+    const Net* net, const InstanceTerm* pin, SteinerPoint pt)
 {
     if (pin == nullptr)
     {
@@ -0,0 +1,130 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/BufferDelayModel.hpp"
+
+#include <algorithm>
+
+namespace psn
+{
+BufferDelayModel::BufferDelayModel()
+    : load_step_(0.0),
+      input_slew_step_(0.0),
+      load_steps_(0),
+      input_slew_steps_(0)
+{
+}
+BufferDelayModel::BufferDelayModel(float max_load, std::vector<float> delays,
+                                   float              max_input_slew,
+                                   size_t             input_slew_steps,
+                                   std::vector<float> slews)
+    : load_step_(0.0),
+      input_slew_step_(0.0),
+      load_steps_(delays.size()),
+      input_slew_steps_(input_slew_steps),
+      delays_(delays),
+      slews_(slews)
+{
+    if (load_steps_ > 1)
+    {
+        load_step_ = max_load / (load_steps_ - 1);
+    }
+    if (input_slew_steps_ > 1 &&
+        slews_.size() == input_slew_steps_ * load_steps_)
+    {
+        input_slew_step_ = max_input_slew / (input_slew_steps_ - 1);
+    }
+    else
+    {
+        input_slew_steps_ = 0;
+        slews_.clear();
+    }
+}
+
+float
+BufferDelayModel::delay(float load_cap) const
+{
+    return interpolate(delays_.data(), load_cap);
+}
+float
+BufferDelayModel::slew(float load_cap, float input_slew) const
+{
+    // Clamped before the cast, NaN or huge positions do not fit a size_t
+    float  pos  = input_slew / input_slew_step_;
+    size_t row  = static_cast<size_t>(
+        std::min(std::max(0.0f, pos), float(input_slew_steps_ - 2)));
+    float  frac = pos - row;
+    float  low  = interpolate(&slews_[row * load_steps_], load_cap);
+    float  high = interpolate(&slews_[(row + 1) * load_steps_], load_cap);
+    return low + (high - low) * frac;
+}
+bool
+BufferDelayModel::hasSlew(float input_slew) const
+{
+    return input_slew_steps_ > 1 && input_slew_step_ > 0.0 &&
+           input_slew >= 0.0 && input_slew <= maxInputSlew();
+}
+bool
+BufferDelayModel::valid() const
+{
+    return load_steps_ > 1 && load_step_ > 0.0;
+}
+float
+BufferDelayModel::maxLoad() const
+{
+    return load_step_ * (load_steps_ - 1);
+}
+float
+BufferDelayModel::maxInputSlew() const
+{
+    return input_slew_steps_ ? input_slew_step_ * (input_slew_steps_ - 1)
+                             : 0.0;
+}
+size_t
+BufferDelayModel::loadSteps() const
+{
+    return load_steps_;
+}
+size_t
+BufferDelayModel::inputSlewSteps() const
+{
+    return input_slew_steps_;
+}
+float
+BufferDelayModel::interpolate(const float* table, float load_cap) const
+{
+    float  pos   = load_cap / load_step_;
+    size_t index = static_cast<size_t>(
+        std::min(std::max(0.0f, pos), float(load_steps_ - 2)));
+    float  frac  = pos - index;
+    return table[index] + (table[index + 1] - table[index]) * frac;
+}
+} // namespace psn
@@ -0,0 +1,317 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/CompiledFunction.hpp"
+#include "sta/FuncExpr.hh"
+
+#include <algorithm>
+
+namespace psn
+{
+// Variable i of the low six is 1 in the lanes whose index has bit i set
+static const uint64_t kProjections[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+static const size_t kLaneBits = 6;
+// Stack words kept on the call stack before evaluate allocates
+static const size_t kLocalStackSize = 32;
+
+CompiledFunction::CompiledFunction() : stack_size_(0), valid_(false)
+{
+}
+
+CompiledFunction::CompiledFunction(const sta::FuncExpr*             func,
+                                   const std::vector<LibraryTerm*>& variables)
+    : variables_(variables),
+      used_(variables.size(), false),
+      stack_size_(0),
+      valid_(func != nullptr)
+{
+    if (valid_)
+    {
+        size_t depth = 0;
+        compile(func, depth);
+    }
+    if (!valid_)
+    {
+        program_.clear();
+    }
+}
+
+void
+CompiledFunction::compile(const sta::FuncExpr* func, size_t& depth)
+{
+    if (!valid_)
+    {
+        return;
+    }
+    Instruction instruction{Zero, 0};
+    switch (func->op())
+    {
+    case sta::FuncExpr::op_port:
+    {
+        int index = variableIndex(func->port());
+        if (index < 0)
+        {
+            valid_ = false;
+            return;
+        }
+        used_[index]         = true;
+        instruction.opcode   = Variable;
+        instruction.variable = index;
+        depth++;
+        break;
+    }
+    case sta::FuncExpr::op_one:
+        instruction.opcode = One;
+        depth++;
+        break;
+    case sta::FuncExpr::op_zero:
+        depth++;
+        break;
+    case sta::FuncExpr::op_not:
+        compile(func->left(), depth);
+        instruction.opcode = Not;
+        break;
+    case sta::FuncExpr::op_and:
+    case sta::FuncExpr::op_or:
+    case sta::FuncExpr::op_xor:
+        compile(func->left(), depth);
+        compile(func->right(), depth);
+        instruction.opcode =
+            func->op() == sta::FuncExpr::op_and
+                ? And
+                : func->op() == sta::FuncExpr::op_or ? Or : Xor;
+        depth--;
+        break;
+    default:
+        valid_ = false;
+        return;
+    }
+    stack_size_ = std::max(stack_size_, depth);
+    program_.push_back(instruction);
+}
+
+bool
+CompiledFunction::valid() const
+{
+    return valid_;
+}
+
+size_t
+CompiledFunction::variableCount() const
+{
+    return variables_.size();
+}
+
+LibraryTerm*
+CompiledFunction::variable(size_t index) const
+{
+    return variables_[index];
+}
+
+int
+CompiledFunction::variableIndex(const LibraryTerm* port) const
+{
+    auto itr = std::find(variables_.begin(), variables_.end(), port);
+    if (itr == variables_.end())
+    {
+        return -1;
+    }
+    return itr - variables_.begin();
+}
+
+bool
+CompiledFunction::dependsOn(size_t variable) const
+{
+    return variable < used_.size() && used_[variable];
+}
+
+uint64_t
+CompiledFunction::evaluate(const uint64_t* values) const
+{
+    uint64_t              local_stack[kLocalStackSize];
+    std::vector<uint64_t> heap_stack;
+    uint64_t*             stack = local_stack;
+    if (stack_size_ > kLocalStackSize)
+    {
+        heap_stack.resize(stack_size_);
+        stack = heap_stack.data();
+    }
+    size_t top = 0;
+    for (auto& instruction : program_)
+    {
+        switch (instruction.opcode)
+        {
+        case Variable:
+            stack[top++] = values[instruction.variable];
+            break;
+        case Zero:
+            stack[top++] = 0;
+            break;
+        case One:
+            stack[top++] = ~0ULL;
+            break;
+        case Not:
+            stack[top - 1] = ~stack[top - 1];
+            break;
+        case And:
+            top--;
+            stack[top - 1] &= stack[top];
+            break;
+        case Or:
+            top--;
+            stack[top - 1] |= stack[top];
+            break;
+        case Xor:
+            top--;
+            stack[top - 1] ^= stack[top];
+            break;
+        }
+    }
+    return top ? stack[0] : 0;
+}
+
+size_t
+CompiledFunction::wordCount() const
+{
+    if (variables_.size() <= kLaneBits)
+    {
+        return 1;
+    }
+    return size_t(1) << (variables_.size() - kLaneBits);
+}
+
+uint64_t
+CompiledFunction::laneMask() const
+{
+    if (variables_.size() >= kLaneBits)
+    {
+        return ~0ULL;
+    }
+    return (1ULL << (1 << variables_.size())) - 1;
+}
+
+void
+CompiledFunction::assignmentWords(size_t word, uint64_t* values) const
+{
+    for (size_t i = 0; i < variables_.size(); i++)
+    {
+        if (i < kLaneBits)
+        {
+            values[i] = kProjections[i];
+        }
+        else
+        {
+            values[i] = ((word >> (i - kLaneBits)) & 1) ? ~0ULL : 0;
+        }
+    }
+}
+
+std::vector<uint64_t>
+CompiledFunction::truthTable() const
+{
+    std::vector<uint64_t> table;
+    if (!valid_)
+    {
+        return table;
+    }
+    std::vector<uint64_t> values(variables_.size());
+    size_t                words = wordCount();
+    table.resize(words);
+    for (size_t w = 0; w < words; w++)
+    {
+        assignmentWords(w, values.data());
+        table[w] = evaluate(values.data()) & laneMask();
+    }
+    return table;
+}
+
+bool
+CompiledFunction::symmetric(size_t first, size_t second) const
+{
+    if (!valid_ || first >= variables_.size() || second >= variables_.size())
+    {
+        return false;
+    }
+    std::vector<uint64_t> values(variables_.size());
+    size_t                words = wordCount();
+    for (size_t w = 0; w < words; w++)
+    {
+        assignmentWords(w, values.data());
+        uint64_t result = evaluate(values.data());
+        std::swap(values[first], values[second]);
+        if ((result ^ evaluate(values.data())) & laneMask())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int
+CompiledFunction::constantCofactor(size_t variable, bool value) const
+{
+    if (!valid_ || variable >= variables_.size())
+    {
+        return -1;
+    }
+    std::vector<uint64_t> values(variables_.size());
+    size_t                words    = wordCount();
+    uint64_t              mask     = laneMask();
+    int                   constant = -1;
+    for (size_t w = 0; w < words; w++)
+    {
+        assignmentWords(w, values.data());
+        values[variable] = value ? ~0ULL : 0;
+        uint64_t result  = evaluate(values.data()) & mask;
+        int      word_constant;
+        if (result == 0)
+        {
+            word_constant = 0;
+        }
+        else if (result == mask)
+        {
+            word_constant = 1;
+        }
+        else
+        {
+            return -1;
+        }
+        if (constant != -1 && constant != word_constant)
+        {
+            return -1;
+        }
+        constant = word_constant;
+    }
+    return constant;
+}
+} // namespace psn
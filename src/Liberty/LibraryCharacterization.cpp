@@ -0,0 +1,507 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/LibraryCharacterization.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace psn
+{
+static const char     kMagic[8] = {'P', 'S', 'N', 'C', 'H', 'A', 'R', '\0'};
+static const uint32_t kVersion  = 2;
+
+namespace
+{
+// Appends fixed-width fields in host byte order, the file is a cache for
+// the same build and not an exchange format.
+class CharacterizationWriter
+{
+public:
+    void
+    put(const void* data, size_t size)
+    {
+        buffer_.append(static_cast<const char*>(data), size);
+    }
+    void
+    putU32(uint32_t value)
+    {
+        put(&value, sizeof(value));
+    }
+    void
+    putU64(uint64_t value)
+    {
+        put(&value, sizeof(value));
+    }
+    void
+    putFloat(float value)
+    {
+        put(&value, sizeof(value));
+    }
+    void
+    putFloats(const std::vector<float>& values)
+    {
+        putU32(values.size());
+        put(values.data(), values.size() * sizeof(float));
+    }
+    void
+    putString(const std::string& value)
+    {
+        putU32(value.size());
+        put(value.data(), value.size());
+    }
+    void
+    putNode(const LibraryCharacterization::MappingNode& node)
+    {
+        putString(node.name);
+        putString(node.id);
+        uint32_t flags = (node.terminal ? 1 : 0) | (node.recurring ? 2 : 0) |
+                         (node.is_buffer ? 4 : 0) | (node.is_inverter ? 8 : 0);
+        putU32(flags);
+        putU32(node.level);
+        putU32(node.children.size());
+        for (auto& child : node.children)
+        {
+            putNode(child);
+        }
+    }
+    const std::string&
+    buffer() const
+    {
+        return buffer_;
+    }
+
+private:
+    std::string buffer_;
+};
+
+// Reads the fields back, every read fails once the data runs out
+class CharacterizationReader
+{
+public:
+    explicit CharacterizationReader(const std::string& data)
+        : data_(data), offset_(0), ok_(true)
+    {
+    }
+    bool
+    get(void* data, size_t size)
+    {
+        if (!ok_ || data_.size() - offset_ < size)
+        {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(data, data_.data() + offset_, size);
+        offset_ += size;
+        return true;
+    }
+    uint32_t
+    getU32()
+    {
+        uint32_t value = 0;
+        get(&value, sizeof(value));
+        return value;
+    }
+    uint64_t
+    getU64()
+    {
+        uint64_t value = 0;
+        get(&value, sizeof(value));
+        return value;
+    }
+    float
+    getFloat()
+    {
+        float value = 0.0;
+        get(&value, sizeof(value));
+        return value;
+    }
+    void
+    getFloats(std::vector<float>& values)
+    {
+        values.resize(getCount(sizeof(float)));
+        if (values.size())
+        {
+            get(values.data(), values.size() * sizeof(float));
+        }
+    }
+    std::string
+    getString()
+    {
+        uint32_t size = getU32();
+        if (!ok_ || data_.size() - offset_ < size)
+        {
+            ok_ = false;
+            return "";
+        }
+        std::string value = data_.substr(offset_, size);
+        offset_ += size;
+        return value;
+    }
+    // A count of entries that each take at least min_size bytes
+    uint32_t
+    getCount(size_t min_size)
+    {
+        uint32_t count = getU32();
+        if (ok_ && count > (data_.size() - offset_) / min_size)
+        {
+            ok_ = false;
+        }
+        return ok_ ? count : 0;
+    }
+    void
+    getNode(LibraryCharacterization::MappingNode& node)
+    {
+        node.name          = getString();
+        node.id            = getString();
+        uint32_t flags     = getU32();
+        node.terminal      = flags & 1;
+        node.recurring     = flags & 2;
+        node.is_buffer     = flags & 4;
+        node.is_inverter   = flags & 8;
+        node.level         = getU32();
+        uint32_t child_cnt = getCount(5 * sizeof(uint32_t));
+        node.children.resize(child_cnt);
+        for (auto& child : node.children)
+        {
+            getNode(child);
+        }
+    }
+    bool
+    ok() const
+    {
+        return ok_;
+    }
+    bool
+    atEnd() const
+    {
+        return offset_ == data_.size();
+    }
+
+private:
+    const std::string& data_;
+    size_t             offset_;
+    bool               ok_;
+};
+} // namespace
+
+static void
+putNamedFloats(CharacterizationWriter&                           writer,
+               const std::vector<std::pair<std::string, float>>& values)
+{
+    writer.putU32(values.size());
+    for (auto& value : values)
+    {
+        writer.putString(value.first);
+        writer.putFloat(value.second);
+    }
+}
+
+static void
+getNamedFloats(CharacterizationReader&                     reader,
+               std::vector<std::pair<std::string, float>>& values)
+{
+    values.resize(reader.getCount(2 * sizeof(uint32_t)));
+    for (auto& value : values)
+    {
+        value.first  = reader.getString();
+        value.second = reader.getFloat();
+    }
+}
+
+static void
+putStrings(CharacterizationWriter&         writer,
+           const std::vector<std::string>& values)
+{
+    writer.putU32(values.size());
+    for (auto& value : values)
+    {
+        writer.putString(value);
+    }
+}
+
+static void
+getStrings(CharacterizationReader& reader, std::vector<std::string>& values)
+{
+    values.resize(reader.getCount(sizeof(uint32_t)));
+    for (auto& value : values)
+    {
+        value = reader.getString();
+    }
+}
+
+LibraryCharacterization::LibraryCharacterization()
+{
+    clear();
+}
+
+uint64_t
+LibraryCharacterization::hash(const void* data, size_t size, uint64_t seed)
+{
+    auto     bytes = static_cast<const unsigned char*>(data);
+    uint64_t value = seed;
+    for (size_t i = 0; i < size; i++)
+    {
+        value ^= bytes[i];
+        value *= 0x100000001b3ULL;
+    }
+    return value;
+}
+
+bool
+LibraryCharacterization::hashFile(const std::string& path, uint64_t& hash)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    char buffer[1 << 16];
+    while (file)
+    {
+        file.read(buffer, sizeof(buffer));
+        hash = LibraryCharacterization::hash(buffer, file.gcount(), hash);
+    }
+    return file.eof();
+}
+
+void
+LibraryCharacterization::clear()
+{
+    key                  = 0;
+    has_target_loads     = false;
+    target_slews[0]      = 0.0;
+    target_slews[1]      = 0.0;
+    has_buffer_models    = false;
+    has_buffer_penalties = false;
+    include_inverting    = false;
+    has_library_mappings = false;
+    mapping_length       = 0;
+    has_buffer_clusters  = false;
+    cluster_threshold    = 0.0;
+    find_superior        = false;
+    cluster_inverting    = false;
+    target_loads.clear();
+    buffer_models.clear();
+    buffer_sequence.clear();
+    inverting_buffers.clear();
+    buffer_penalties.clear();
+    inverting_penalties.clear();
+    truth_tables.clear();
+    mappings.clear();
+    cluster_buffers.clear();
+    cluster_inverters.clear();
+}
+
+bool
+LibraryCharacterization::read(const std::string& path, uint64_t expected_key)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string            data = contents.str();
+    CharacterizationReader reader(data);
+
+    char magic[sizeof(kMagic)];
+    if (!reader.get(magic, sizeof(magic)) ||
+        std::memcmp(magic, kMagic, sizeof(kMagic)) ||
+        reader.getU32() != kVersion || reader.getU64() != expected_key)
+    {
+        return false;
+    }
+
+    LibraryCharacterization result;
+    result.key              = expected_key;
+    result.has_target_loads = reader.getU32();
+    if (result.has_target_loads)
+    {
+        result.target_slews[0] = reader.getFloat();
+        result.target_slews[1] = reader.getFloat();
+        getNamedFloats(reader, result.target_loads);
+    }
+    result.has_buffer_models = reader.getU32();
+    if (result.has_buffer_models)
+    {
+        result.buffer_models.resize(reader.getCount(6 * sizeof(uint32_t)));
+        for (auto& model : result.buffer_models)
+        {
+            model.cell             = reader.getString();
+            model.max_load         = reader.getFloat();
+            model.max_input_slew   = reader.getFloat();
+            model.input_slew_steps = reader.getU32();
+            reader.getFloats(model.delays);
+            reader.getFloats(model.slews);
+        }
+    }
+    result.has_buffer_penalties = reader.getU32();
+    if (result.has_buffer_penalties)
+    {
+        result.include_inverting = reader.getU32();
+        getStrings(reader, result.buffer_sequence);
+        getStrings(reader, result.inverting_buffers);
+        getNamedFloats(reader, result.buffer_penalties);
+        getNamedFloats(reader, result.inverting_penalties);
+    }
+    result.has_library_mappings = reader.getU32();
+    if (result.has_library_mappings)
+    {
+        result.mapping_length = reader.getU32();
+        result.truth_tables.resize(reader.getCount(2 * sizeof(uint32_t)));
+        for (auto& table : result.truth_tables)
+        {
+            table.first  = reader.getString();
+            table.second = reader.getString();
+        }
+        result.mappings.resize(reader.getCount(2 * sizeof(uint32_t)));
+        for (auto& mapping : result.mappings)
+        {
+            mapping.id = reader.getString();
+            mapping.roots.resize(reader.getCount(5 * sizeof(uint32_t)));
+            for (auto& root : mapping.roots)
+            {
+                reader.getNode(root);
+            }
+        }
+    }
+    result.has_buffer_clusters = reader.getU32();
+    if (result.has_buffer_clusters)
+    {
+        result.cluster_threshold = reader.getFloat();
+        result.find_superior     = reader.getU32();
+        result.cluster_inverting = reader.getU32();
+        getStrings(reader, result.cluster_buffers);
+        getStrings(reader, result.cluster_inverters);
+    }
+    if (!reader.ok() || !reader.atEnd())
+    {
+        return false;
+    }
+    *this = std::move(result);
+    return true;
+}
+
+bool
+LibraryCharacterization::write(const std::string& path) const
+{
+    CharacterizationWriter writer;
+    writer.put(kMagic, sizeof(kMagic));
+    writer.putU32(kVersion);
+    writer.putU64(key);
+    writer.putU32(has_target_loads);
+    if (has_target_loads)
+    {
+        writer.putFloat(target_slews[0]);
+        writer.putFloat(target_slews[1]);
+        putNamedFloats(writer, target_loads);
+    }
+    writer.putU32(has_buffer_models);
+    if (has_buffer_models)
+    {
+        writer.putU32(buffer_models.size());
+        for (auto& model : buffer_models)
+        {
+            writer.putString(model.cell);
+            writer.putFloat(model.max_load);
+            writer.putFloat(model.max_input_slew);
+            writer.putU32(model.input_slew_steps);
+            writer.putFloats(model.delays);
+            writer.putFloats(model.slews);
+        }
+    }
+    writer.putU32(has_buffer_penalties);
+    if (has_buffer_penalties)
+    {
+        writer.putU32(include_inverting);
+        putStrings(writer, buffer_sequence);
+        putStrings(writer, inverting_buffers);
+        putNamedFloats(writer, buffer_penalties);
+        putNamedFloats(writer, inverting_penalties);
+    }
+    writer.putU32(has_library_mappings);
+    if (has_library_mappings)
+    {
+        writer.putU32(mapping_length);
+        writer.putU32(truth_tables.size());
+        for (auto& table : truth_tables)
+        {
+            writer.putString(table.first);
+            writer.putString(table.second);
+        }
+        writer.putU32(mappings.size());
+        for (auto& mapping : mappings)
+        {
+            writer.putString(mapping.id);
+            writer.putU32(mapping.roots.size());
+            for (auto& root : mapping.roots)
+            {
+                writer.putNode(root);
+            }
+        }
+    }
+    writer.putU32(has_buffer_clusters);
+    if (has_buffer_clusters)
+    {
+        writer.putFloat(cluster_threshold);
+        writer.putU32(find_superior);
+        writer.putU32(cluster_inverting);
+        putStrings(writer, cluster_buffers);
+        putStrings(writer, cluster_inverters);
+    }
+
+    std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+        file.write(writer.buffer().data(), writer.buffer().size());
+        if (!file)
+        {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()))
+    {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+} // namespace psn
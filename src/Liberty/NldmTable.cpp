@@ -0,0 +1,160 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/NldmTable.hpp"
+
+#include <algorithm>
+
+namespace psn
+{
+static std::vector<float>
+inverseSteps(const std::vector<float>& axis)
+{
+    std::vector<float> inverse_steps(std::max<size_t>(axis.size(), 2) - 1,
+                                     0.0);
+    for (size_t i = 0; i + 1 < axis.size(); i++)
+    {
+        float step       = axis[i + 1] - axis[i];
+        inverse_steps[i] = step > 0.0 ? 1.0 / step : 0.0;
+    }
+    return inverse_steps;
+}
+
+NldmTable::NldmTable()
+{
+}
+NldmTable::NldmTable(std::vector<float> slew_axis,
+                     std::vector<float> load_axis, std::vector<float> values)
+    : slew_axis_(slew_axis), load_axis_(load_axis), values_(values)
+{
+    if (slew_axis_.empty())
+    {
+        slew_axis_.push_back(0.0);
+    }
+    if (load_axis_.empty())
+    {
+        load_axis_.push_back(0.0);
+    }
+    if (values_.size() != slew_axis_.size() * load_axis_.size())
+    {
+        values_.clear();
+    }
+    slew_inverse_steps_ = inverseSteps(slew_axis_);
+    load_inverse_steps_ = inverseSteps(load_axis_);
+}
+
+float
+NldmTable::lookup(float input_slew, float load_cap) const
+{
+    size_t row_size = load_axis_.size();
+    size_t next_row = slew_axis_.size() > 1 ? row_size : 0;
+    size_t next_col = row_size > 1 ? 1 : 0;
+    size_t row, col;
+    float  row_frac, col_frac;
+    segment(slew_axis_, slew_inverse_steps_, input_slew, row, row_frac);
+    segment(load_axis_, load_inverse_steps_, load_cap, col, col_frac);
+    const float* low        = values_.data() + row * row_size + col;
+    const float* high       = low + next_row;
+    float        low_value  = low[0] + (low[next_col] - low[0]) * col_frac;
+    float        high_value = high[0] + (high[next_col] - high[0]) * col_frac;
+    return low_value + (high_value - low_value) * row_frac;
+}
+void
+NldmTable::lookup(const float* input_slews, const float* load_caps,
+                  float* results, size_t count) const
+{
+    const size_t block_size = 64;
+    size_t       row_size   = load_axis_.size();
+    size_t       next_row   = slew_axis_.size() > 1 ? row_size : 0;
+    size_t       next_col   = row_size > 1 ? 1 : 0;
+    size_t       rows[block_size], cols[block_size];
+    float        row_fracs[block_size], col_fracs[block_size];
+    for (size_t begin = 0; begin < count; begin += block_size)
+    {
+        size_t size = std::min(block_size, count - begin);
+        segments(slew_axis_, slew_inverse_steps_, input_slews + begin, size,
+                 rows, row_fracs);
+        segments(load_axis_, load_inverse_steps_, load_caps + begin, size,
+                 cols, col_fracs);
+        for (size_t k = 0; k < size; k++)
+        {
+            const float* low  = values_.data() + rows[k] * row_size + cols[k];
+            const float* high = low + next_row;
+            float low_value = low[0] + (low[next_col] - low[0]) * col_fracs[k];
+            float high_value =
+                high[0] + (high[next_col] - high[0]) * col_fracs[k];
+            results[begin + k] =
+                low_value + (high_value - low_value) * row_fracs[k];
+        }
+    }
+}
+bool
+NldmTable::valid() const
+{
+    return !values_.empty();
+}
+void
+NldmTable::segment(const std::vector<float>& axis,
+                   const std::vector<float>& inverse_steps, float value,
+                   size_t& index, float& frac)
+{
+    // Counting the inner breakpoints below the value picks the segment
+    // without branches, the first and last segments extrapolate
+    index = 0;
+    for (size_t i = 1; i + 1 < axis.size(); i++)
+    {
+        index += value >= axis[i];
+    }
+    frac = (value - axis[index]) * inverse_steps[index];
+}
+void
+NldmTable::segments(const std::vector<float>& axis,
+                    const std::vector<float>& inverse_steps,
+                    const float* values, size_t count, size_t* indices,
+                    float* fracs)
+{
+    // Same count as segment, with the breakpoints in the outer loop so that
+    // the inner loops run over the whole block
+    std::fill(indices, indices + count, 0);
+    for (size_t i = 1; i + 1 < axis.size(); i++)
+    {
+        float breakpoint = axis[i];
+        for (size_t k = 0; k < count; k++)
+        {
+            indices[k] += values[k] >= breakpoint;
+        }
+    }
+    for (size_t k = 0; k < count; k++)
+    {
+        fracs[k] = (values[k] - axis[indices[k]]) * inverse_steps[indices[k]];
+    }
+}
+} // namespace psn
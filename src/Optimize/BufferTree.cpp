@@ -38,6 +38,9 @@
 #include "OpenPhySyn/Utils/PsnGlobal.hpp"
 #include "PsnLogger/PsnLogger.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <memory>
 
 
@@ -56,6 +59,7 @@ BufferTree::BufferTree(float cap, float req, float cost, Point location,
       location_(location),
       left_(nullptr),
       right_(nullptr),
+      arena_(nullptr),
       buffer_cell_(buffer_cell),
       pin_(pin),
       library_pin_(library_pin),
@@ -69,8 +73,8 @@ BufferTree::BufferTree(float cap, float req, float cost, Point location,
 
 {
 }
-BufferTree::BufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-                       std::shared_ptr<BufferTree> right, Point location)
+BufferTree::BufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+                       Point location)
     : capacitance_(left->totalCapacitance() + right->totalCapacitance()),
       required_or_slew_(left->mode() == Timerless
                             ? (std::max(left->totalRequiredOrSlew(),
@@ -83,12 +87,13 @@ BufferTree::BufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
       location_(location),
       left_(left),
       right_(right),
+      arena_(nullptr),
       buffer_cell_(nullptr),
       pin_(),
       library_pin_(left->libraryPin()),
       upstream_buffer_cell_(nullptr),
       driver_cell_(nullptr),
-      polarity_(0),
+      polarity_(left->polarity()),
       buffer_count_(left->bufferCount() + right->bufferCount()),
       mode_(left->mode()),
       library_mapping_node_(nullptr),
@@ -183,14 +188,14 @@ BufferTree::checkLimits(Psn* psn_inst, LibraryTerm* driver_pin,
     DatabaseHandler& handler = *(psn_inst->handler());
 
     bool left_check =
-        left() == nullptr ||
-        left()->checkLimits(
+        left_ == nullptr ||
+        left_->checkLimits(
             psn_inst,
             hasBufferCell() ? handler.bufferOutputPin(bufferCell()) : nullptr,
             slew_limit, cap_limit);
     bool right_check =
-        right() == nullptr ||
-        right()->checkLimits(
+        right_ == nullptr ||
+        right_->checkLimits(
             psn_inst,
             hasBufferCell() ? handler.bufferOutputPin(bufferCell()) : nullptr,
             slew_limit, cap_limit);
@@ -281,9 +286,8 @@ BufferTree::mode() const
 float
 BufferTree::bufferSlew(Psn* psn_inst, LibraryCell* buffer_cell, float tr_slew)
 {
-    return psn_inst->handler()->slew(
-        psn_inst->handler()->bufferOutputPin(buffer_cell), totalCapacitance(),
-        &tr_slew);
+    return psn_inst->handler()->bufferSlew(buffer_cell, totalCapacitance(),
+                                           tr_slew);
 }
 float
 BufferTree::bufferFixedInputSlew(Psn* psn_inst, LibraryCell* buffer_cell)
@@ -352,23 +356,53 @@ BufferTree::libraryPin() const
 std::shared_ptr<BufferTree>
 BufferTree::left()
 {
-    return left_;
+    if (!left_ || !arena_)
+    {
+        return std::shared_ptr<BufferTree>(std::shared_ptr<BufferTree>(),
+                                           left_);
+    }
+    return arena_->share(left_);
 }
 std::shared_ptr<BufferTree>
 BufferTree::right()
+{
+    if (!right_ || !arena_)
+    {
+        return std::shared_ptr<BufferTree>(std::shared_ptr<BufferTree>(),
+                                           right_);
+    }
+    return arena_->share(right_);
+}
+BufferTree*
+BufferTree::leftNode() const
+{
+    return left_;
+}
+BufferTree*
+BufferTree::rightNode() const
 {
     return right_;
 }
 void
-BufferTree::setLeft(std::shared_ptr<BufferTree> left)
+BufferTree::setLeft(BufferTree* left)
 {
     left_ = left;
 }
 void
-BufferTree::setRight(std::shared_ptr<BufferTree> right)
+BufferTree::setRight(BufferTree* right)
 {
     right_ = right;
 }
+BufferTreeArena*
+BufferTree::arena() const
+{
+    return arena_;
+}
+void
+BufferTree::setArena(BufferTreeArena* arena)
+{
+    arena_ = arena;
+}
 bool
 BufferTree::hasUpstreamBufferCell() const
 {
@@ -520,66 +554,270 @@ TimerlessBufferTree::TimerlessBufferTree(float cap, float req, float cost,
                  polarity, BufferMode::Timerless)
 {
 }
-TimerlessBufferTree::TimerlessBufferTree(Psn*                        psn_inst,
-                                         std::shared_ptr<BufferTree> left,
-                                         std::shared_ptr<BufferTree> right,
-                                         Point                       location)
+TimerlessBufferTree::TimerlessBufferTree(Psn* psn_inst, BufferTree* left,
+                                         BufferTree* right, Point location)
     : BufferTree(psn_inst, left, right, location)
 {
     setMode(BufferMode::Timerless);
 }
 
-BufferSolution::BufferSolution(BufferMode buffer_mode) : mode_(buffer_mode){};
+BufferTreeArena::BufferTreeArena(size_t block_size)
+    : block_size_(block_size), used_(0), size_(0)
+{
+}
+BufferTreeArena::~BufferTreeArena()
+{
+    std::unordered_set<BufferTree*> released(free_nodes_.begin(),
+                                             free_nodes_.end());
+    for (size_t i = 0; i < blocks_.size(); i++)
+    {
+        size_t block_used = (i + 1 == blocks_.size()) ? used_ : block_size_;
+        for (size_t j = 0; j < block_used; j++)
+        {
+            auto node = reinterpret_cast<BufferTree*>(&blocks_[i][j]);
+            if (!released.count(node))
+            {
+                node->~BufferTree();
+            }
+        }
+    }
+}
+void
+BufferTreeArena::release(BufferTree* node)
+{
+    node->~BufferTree();
+    free_nodes_.push_back(node);
+    size_--;
+}
+BufferTree*
+BufferTreeArena::retain(std::shared_ptr<BufferTree> tree)
+{
+    retained_.push_back(tree);
+    return tree.get();
+}
+std::shared_ptr<BufferTree>
+BufferTreeArena::share(BufferTree* node)
+{
+    if (!node)
+    {
+        return nullptr;
+    }
+    return std::shared_ptr<BufferTree>(shared_from_this(), node);
+}
+size_t
+BufferTreeArena::size() const
+{
+    return size_;
+}
+
+BufferSolution::BufferSolution(BufferMode                       buffer_mode,
+                               std::shared_ptr<BufferTreeArena> arena)
+    : mode_(buffer_mode), arena_(arena)
+{
+    if (!arena_)
+    {
+        arena_ = std::make_shared<BufferTreeArena>();
+    }
+}
 BufferSolution::BufferSolution(Psn*                             psn_inst,
                                std::shared_ptr<BufferSolution>& left,
                                std::shared_ptr<BufferSolution>& right,
                                Point location, LibraryCell* upstream_res_cell,
                                float      minimum_upstream_res_or_max_slew,
-                               BufferMode buffer_mode)
-    : mode_(buffer_mode)
+                               BufferMode buffer_mode, bool squeeze_candidates)
+    : mode_(buffer_mode), arena_(left->arena())
 
 {
     mergeBranches(psn_inst, left, right, location, upstream_res_cell,
-                  minimum_upstream_res_or_max_slew);
+                  minimum_upstream_res_or_max_slew, squeeze_candidates);
 }
 void
 BufferSolution::mergeBranches(Psn*                             psn_inst,
                               std::shared_ptr<BufferSolution>& left,
                               std::shared_ptr<BufferSolution>& right,
                               Point location, LibraryCell* upstream_res_cell,
-                              float minimum_upstream_res_or_max_slew)
+                              float minimum_upstream_res_or_max_slew,
+                              bool  squeeze_candidates)
 {
-    buffer_trees_.resize(left->bufferTrees().size() *
-                             right->bufferTrees().size());
-    int index = 0;
-    for (auto& left_branch : left->bufferTrees())
+    // Both branches are expected to share the same arena
+    if (!arena_)
     {
-        for (auto& right_branch : right->bufferTrees())
+        arena_ = left->arena();
+    }
+    bool timerless = isTimerless();
+    // The merged required time is the minimum of both branches (the maximum
+    // slew for timerless buffering); higher quality is better.
+    auto quality = [timerless](BufferTree* tree) -> float {
+        return timerless ? -tree->totalRequiredOrSlew()
+                         : tree->totalRequiredOrSlew();
+    };
+    auto by_polarity = [&quality](BufferTree* a, BufferTree* b) -> bool {
+        return a->polarity() < b->polarity() ||
+               (a->polarity() == b->polarity() && quality(a) > quality(b));
+    };
+    auto& left_trees  = left->trees();
+    auto& right_trees = right->trees();
+    std::sort(left_trees.begin(), left_trees.end(), by_polarity);
+    std::sort(right_trees.begin(), right_trees.end(), by_polarity);
+
+    auto merge = [&](BufferTree* tree, BufferTree* partner,
+                     bool tree_is_left) {
+        auto left_branch  = tree_is_left ? tree : partner;
+        auto right_branch = tree_is_left ? partner : tree;
+        buffer_trees_.push_back(
+            timerless ? arena_->create<TimerlessBufferTree>(
+                            psn_inst, left_branch, right_branch, location)
+                      : arena_->create<BufferTree>(psn_inst, left_branch,
+                                                   right_branch, location));
+    };
+    // Adds a partner to the (capacitance, cost) staircase, which is sorted by
+    // increasing capacitance with strictly decreasing cost so that no step
+    // dominates another.
+    auto add_step = [](std::vector<BufferTree*>& steps, BufferTree* partner) {
+        float cap  = partner->totalCapacitance();
+        float cost = partner->cost();
+        auto  pos  = std::lower_bound(
+            steps.begin(), steps.end(), cap,
+            [](BufferTree* step, float value) -> bool {
+                return step->totalCapacitance() < value;
+            });
+        if ((pos != steps.begin() && (*(pos - 1))->cost() <= cost) ||
+            (pos != steps.end() && (*pos)->totalCapacitance() == cap &&
+             (*pos)->cost() <= cost))
         {
-            if (left_branch->polarity() == right_branch->polarity())
+            return;
+        }
+        auto dominated_end = pos;
+        while (dominated_end != steps.end() &&
+               (*dominated_end)->cost() >= cost)
+        {
+            dominated_end++;
+        }
+        pos = steps.erase(pos, dominated_end);
+        steps.insert(pos, partner);
+    };
+    // Pairs each limiting candidate with every step of the capacitance and
+    // cost staircase of the partners that do not limit its quality. The
+    // partners are swept once with two pointers and dominated pairs are
+    // never created.
+    auto merge_buckets = [&](std::vector<BufferTree*>& limiting,
+                             size_t limiting_begin, size_t limiting_end,
+                             std::vector<BufferTree*>& partners,
+                             size_t partners_begin, size_t partners_end,
+                             bool limiting_is_left, bool strict) {
+        size_t                   next = partners_begin;
+        std::vector<BufferTree*> steps;
+        for (size_t i = limiting_begin; i < limiting_end; i++)
+        {
+            auto  tree          = limiting[i];
+            float limit_quality = quality(tree);
+            while (next < partners_end &&
+                   (strict ? quality(partners[next]) > limit_quality
+                           : quality(partners[next]) >= limit_quality))
             {
-                buffer_trees_[index++] =
-                    isTimerless()
-                        ? std::make_shared<TimerlessBufferTree>(
-                              psn_inst, left_branch, right_branch, location)
-                        : std::make_shared<BufferTree>(psn_inst, left_branch,
-                                                       right_branch, location);
+                add_step(steps, partners[next++]);
+            }
+            for (auto& partner : steps)
+            {
+                merge(tree, partner, limiting_is_left);
             }
         }
+    };
+
+    buffer_trees_.clear();
+    size_t left_begin = 0, right_begin = 0;
+    while (left_begin < left_trees.size() && right_begin < right_trees.size())
+    {
+        int polarity = std::max(left_trees[left_begin]->polarity(),
+                                right_trees[right_begin]->polarity());
+        while (left_begin < left_trees.size() &&
+               left_trees[left_begin]->polarity() < polarity)
+        {
+            left_begin++;
+        }
+        while (right_begin < right_trees.size() &&
+               right_trees[right_begin]->polarity() < polarity)
+        {
+            right_begin++;
+        }
+        size_t left_end  = left_begin;
+        size_t right_end = right_begin;
+        while (left_end < left_trees.size() &&
+               left_trees[left_end]->polarity() == polarity)
+        {
+            left_end++;
+        }
+        while (right_end < right_trees.size() &&
+               right_trees[right_end]->polarity() == polarity)
+        {
+            right_end++;
+        }
+        // Ties in quality are paired once, from the left side
+        merge_buckets(left_trees, left_begin, left_end, right_trees,
+                      right_begin, right_end, true, false);
+        merge_buckets(right_trees, right_begin, right_end, left_trees,
+                      left_begin, left_end, false, true);
+        left_begin  = left_end;
+        right_begin = right_end;
+    }
+    std::vector<BufferTree*> merged_trees(buffer_trees_);
+    prune(psn_inst, upstream_res_cell, minimum_upstream_res_or_max_slew, 1E-6F,
+          1E-6F, squeeze_candidates);
+
+    // The pruned merge nodes are not referenced anywhere else
+    std::unordered_set<BufferTree*> kept_trees(buffer_trees_.begin(),
+                                               buffer_trees_.end());
+    for (auto& tree : merged_trees)
+    {
+        if (!kept_trees.count(tree))
+        {
+            arena_->release(tree);
+        }
     }
-    buffer_trees_.resize(index);
-    prune(psn_inst, upstream_res_cell, minimum_upstream_res_or_max_slew);
 }
 void
 BufferSolution::addTree(std::shared_ptr<BufferTree>& tree)
+{
+    if (tree->arena() == arena_.get())
+    {
+        buffer_trees_.push_back(tree.get());
+    }
+    else
+    {
+        buffer_trees_.push_back(arena_->retain(tree));
+    }
+}
+void
+BufferSolution::addTree(BufferTree* tree)
 {
     buffer_trees_.push_back(tree);
 }
-std::vector<std::shared_ptr<BufferTree>>&
+std::vector<std::shared_ptr<BufferTree>>
 BufferSolution::bufferTrees()
+{
+    std::vector<std::shared_ptr<BufferTree>> shared_trees;
+    shared_trees.reserve(buffer_trees_.size());
+    for (auto& tree : buffer_trees_)
+    {
+        shared_trees.push_back(arena_->share(tree));
+    }
+    return shared_trees;
+}
+std::shared_ptr<BufferTree>
+BufferSolution::bufferTree(size_t index)
+{
+    return arena_->share(buffer_trees_[index]);
+}
+std::vector<BufferTree*>&
+BufferSolution::trees()
 {
     return buffer_trees_;
 }
+std::shared_ptr<BufferTreeArena>
+BufferSolution::arena() const
+{
+    return arena_;
+}
 void
 BufferSolution::addWireDelayAndCapacitance(float wire_res, float wire_cap)
 {
@@ -591,6 +829,18 @@ BufferSolution::addWireDelayAndCapacitance(float wire_res, float wire_cap)
     }
 }
 void
+BufferSolution::extendWireDelayAndCapacitance(float wire_res, float wire_cap)
+{
+    for (auto& tree : buffer_trees_)
+    {
+        // The new segment also drives the downstream wire
+        float downstream_cap = tree->wireCapacitance();
+        tree->setWireDelayOrSlew(tree->wireDelayOrSlew() +
+                                 wire_res * (wire_cap + downstream_cap));
+        tree->setWireCapacitance(downstream_cap + wire_cap);
+    }
+}
+void
 BufferSolution::addWireSlewAndCapacitance(float wire_res, float wire_cap)
 {
     for (auto& tree : buffer_trees_)
@@ -631,7 +881,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
             }
             auto buffer_cost = psn_inst->handler()->area(buff);
             auto buffer_cap = psn_inst->handler()->bufferInputCapacitance(buff);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            auto buffer_opt = arena_->create<BufferTree>(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, buff);
             buffer_opt->setBufferCount(optimal_tree->bufferCount() + 1);
@@ -654,7 +904,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
             auto buffer_cost = psn_inst->handler()->area(inv);
             auto buffer_cap =
                 psn_inst->handler()->inverterInputCapacitance(inv);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            auto buffer_opt = arena_->create<BufferTree>(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, inv);
 
@@ -668,12 +918,11 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
     else
     {
         std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [](const std::shared_ptr<BufferTree>& a,
-                      const std::shared_ptr<BufferTree>& b) -> bool {
+                  [](BufferTree* a, BufferTree* b) -> bool {
                       return a->cost() < b->cost();
                   });
         // auto sol_tree = buffer_trees_[0];
-        std::vector<std::shared_ptr<BufferTree>> new_trees;
+        std::vector<BufferTree*> new_trees;
         for (auto& buff : buffer_lib)
         {
             for (auto& sol_tree : buffer_trees_)
@@ -685,7 +934,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
                     sol_tree->bufferSlew(psn_inst, buff, slew_limit);
                 if (buffer_slew < slew_limit)
                 {
-                    auto buffer_opt = std::make_shared<TimerlessBufferTree>(
+                    auto buffer_opt = arena_->create<TimerlessBufferTree>(
                         buffer_cap, 0, sol_tree->cost() + buffer_cost, pt,
                         nullptr, nullptr, buff);
                     buffer_opt->setBufferCount(sol_tree->bufferCount() + 1);
@@ -705,7 +954,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
                 float buffer_slew = sol_tree->bufferSlew(psn_inst, inv);
                 if (buffer_slew < slew_limit)
                 {
-                    auto buffer_opt = std::make_shared<TimerlessBufferTree>(
+                    auto buffer_opt = arena_->create<TimerlessBufferTree>(
                         buffer_cap, 0, sol_tree->cost() + buffer_cost, pt,
                         nullptr, nullptr, inv);
                     buffer_opt->setBufferCount(sol_tree->bufferCount() + 1);
@@ -722,7 +971,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
         buffer_trees_.erase(
             std::remove_if(
                 buffer_trees_.begin(), buffer_trees_.end(),
-                [psn_inst, slew_limit](const std::shared_ptr<BufferTree>& t) -> bool {
+                [psn_inst, slew_limit](BufferTree* t) -> bool {
                     if ((t->isBufferNode() &&
                          std::sqrt(std::pow(t->totalRequiredOrSlew(), 2) +
                                    std::pow(psn_inst->handler()->bufferDelay(
@@ -771,7 +1020,7 @@ BufferSolution::addLeafTreesWithResynthesis(
         }
         auto buffer_cost = psn_inst->handler()->area(buff);
         auto buffer_cap  = psn_inst->handler()->bufferInputCapacitance(buff);
-        auto buffer_opt  = std::make_shared<BufferTree>(
+        auto buffer_opt  = arena_->create<BufferTree>(
             buffer_cap, buff_required, optimal_tree->cost() + buffer_cost, pt,
             nullptr, nullptr, buff);
         buffer_opt->setBufferCount(optimal_tree->bufferCount() + 1);
@@ -797,7 +1046,7 @@ BufferSolution::addLeafTreesWithResynthesis(
             auto buffer_cost = psn_inst->handler()->area(inv);
             auto buffer_cap =
                 psn_inst->handler()->inverterInputCapacitance(inv);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            auto buffer_opt = arena_->create<BufferTree>(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, inv);
 
@@ -835,7 +1084,7 @@ BufferSolution::addLeafTreesWithResynthesis(
                     auto buffer_cost = psn_inst->handler()->area(buff);
                     auto buffer_cap =
                         psn_inst->handler()->bufferInputCapacitance(buff);
-                    auto buffer_opt = std::make_shared<BufferTree>(
+                    auto buffer_opt = arena_->create<BufferTree>(
                         buffer_cap, buff_required,
                         optimal_tree->cost() + buffer_cost, pt, nullptr,
                         nullptr, buff);
@@ -867,7 +1116,7 @@ BufferSolution::addLeafTreesWithResynthesis(
                         auto buffer_cost = psn_inst->handler()->area(inv);
                         auto buffer_cap =
                             psn_inst->handler()->inverterInputCapacitance(inv);
-                        auto buffer_opt = std::make_shared<BufferTree>(
+                        auto buffer_opt = arena_->create<BufferTree>(
                             buffer_cap, buff_required,
                             optimal_tree->cost() + buffer_cost, pt, nullptr,
                             nullptr, inv);
@@ -886,11 +1135,11 @@ BufferSolution::addLeafTreesWithResynthesis(
     }
 }
 void
-BufferSolution::addUpstreamReferences(
-    Psn* psn_inst, std::shared_ptr<BufferTree> base_buffer_tree)
+BufferSolution::addUpstreamReferences(Psn*        psn_inst,
+                                      BufferTree* base_buffer_tree)
 {
     return; // Not used anymore..
-    for (auto& tree : bufferTrees())
+    for (auto& tree : buffer_trees_)
     {
         if (tree != base_buffer_tree)
         {
@@ -910,6 +1159,164 @@ BufferSolution::addUpstreamReferences(
     }
 }
 
+void
+BufferSolution::boundCandidates(int max_candidates, float required_grid,
+                                float capacitance_grid,
+                                CandidateBoundStats& stats)
+{
+    stats.evaluated_candidates += buffer_trees_.size();
+    if (max_candidates <= 0 ||
+        buffer_trees_.size() <= static_cast<size_t>(max_candidates))
+    {
+        return;
+    }
+    stats.bounded_points++;
+    size_t initial_count = buffer_trees_.size();
+    bool   timerless     = isTimerless();
+
+    struct GridCandidate
+    {
+        BufferTree* tree;
+        double      capacitance_cell;
+        double      required_cell;
+        float       quality; // Higher is better
+    };
+    std::vector<GridCandidate> candidates;
+    candidates.reserve(buffer_trees_.size());
+    for (auto& tree : buffer_trees_)
+    {
+        float cap = tree->totalCapacitance();
+        float req = tree->totalRequiredOrSlew();
+        candidates.push_back(
+            {tree,
+             capacitance_grid > 0 ? std::floor(cap / capacitance_grid) : cap,
+             required_grid > 0 ? std::floor(req / required_grid) : req,
+             timerless ? -req : req});
+    }
+    // Cells are ordered by polarity then capacitance, the cheapest candidate
+    // leads each cell
+    std::sort(candidates.begin(), candidates.end(),
+              [](const GridCandidate& a, const GridCandidate& b) -> bool {
+                  if (a.tree->polarity() != b.tree->polarity())
+                  {
+                      return a.tree->polarity() < b.tree->polarity();
+                  }
+                  if (a.capacitance_cell != b.capacitance_cell)
+                  {
+                      return a.capacitance_cell < b.capacitance_cell;
+                  }
+                  if (a.required_cell != b.required_cell)
+                  {
+                      return a.required_cell < b.required_cell;
+                  }
+                  if (a.tree->cost() != b.tree->cost())
+                  {
+                      return a.tree->cost() < b.tree->cost();
+                  }
+                  return a.quality > b.quality;
+              });
+    size_t index = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        auto& lead = candidates[index > 0 ? index - 1 : 0];
+        if (index > 0 &&
+            lead.tree->polarity() == candidates[i].tree->polarity() &&
+            lead.capacitance_cell == candidates[i].capacitance_cell &&
+            lead.required_cell == candidates[i].required_cell)
+        {
+            stats.max_required_loss = std::max(
+                stats.max_required_loss, candidates[i].quality - lead.quality);
+            continue;
+        }
+        candidates[index++] = candidates[i];
+    }
+    candidates.resize(index);
+
+    buffer_trees_.clear();
+    if (candidates.size() <= static_cast<size_t>(max_candidates))
+    {
+        for (auto& cand : candidates)
+        {
+            buffer_trees_.push_back(cand.tree);
+        }
+    }
+    else
+    {
+        // Sample each polarity evenly along the capacitance axis, keeping
+        // both ends of its range and its best candidate
+        auto by_quality = [](const GridCandidate& a,
+                             const GridCandidate& b) -> bool {
+            return a.quality < b.quality;
+        };
+        size_t begin = 0;
+        while (begin < candidates.size())
+        {
+            size_t end = begin;
+            while (end < candidates.size() &&
+                   candidates[end].tree->polarity() ==
+                       candidates[begin].tree->polarity())
+            {
+                end++;
+            }
+            size_t count = end - begin;
+            size_t quota = std::max<size_t>(
+                1, max_candidates * count / candidates.size());
+            if (quota >= count)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    buffer_trees_.push_back(candidates[i].tree);
+                }
+            }
+            else
+            {
+                size_t best = std::max_element(candidates.begin() + begin,
+                                               candidates.begin() + end,
+                                               by_quality) -
+                              candidates.begin() - begin;
+                if (quota == 1)
+                {
+                    buffer_trees_.push_back(candidates[begin + best].tree);
+                }
+                else
+                {
+                    std::vector<size_t> offsets(quota);
+                    for (size_t i = 0; i < quota; i++)
+                    {
+                        offsets[i] = (i * (count - 1) + (quota - 1) / 2) /
+                                     (quota - 1);
+                    }
+                    // The closest sample gives way to the best candidate,
+                    // the offsets stay sorted
+                    auto next = std::lower_bound(offsets.begin(),
+                                                 offsets.end(), best);
+                    if (*next != best)
+                    {
+                        if (next != offsets.begin() &&
+                            best - *std::prev(next) < *next - best)
+                        {
+                            next--;
+                        }
+                        *next = best;
+                    }
+                    for (auto& offset : offsets)
+                    {
+                        buffer_trees_.push_back(
+                            candidates[begin + offset].tree);
+                    }
+                }
+            }
+            begin = end;
+        }
+    }
+    stats.dropped_candidates += initial_count - buffer_trees_.size();
+}
+const CandidateBoundStats&
+BufferSolution::boundStats() const
+{
+    return bound_stats_;
+}
+
 std::shared_ptr<BufferTree>
 BufferSolution::optimalDriverTreeWithResize(
     Psn* psn_inst, InstanceTerm* driver_pin,
@@ -922,7 +1329,7 @@ BufferSolution::optimalDriverTreeWithResize(
     float                       max_slack;
     std::shared_ptr<BufferTree> temp_tree;
     auto                        max_tree =
-        optimalDriverTree(psn_inst, driver_pin, temp_tree, &max_slack);
+        optimalDriverTree(psn_inst, driver_pin, temp_tree, &max_slack).get();
     auto inst         = psn_inst->handler()->instance(driver_pin);
     auto original_lib = psn_inst->handler()->libraryCell(inst);
     max_tree->setDriverCell(original_lib);
@@ -955,7 +1362,7 @@ BufferSolution::optimalDriverTreeWithResize(
             }
         }
     }
-    return max_tree;
+    return arena_->share(max_tree);
 }
 std::shared_ptr<BufferTree>
 BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
@@ -970,8 +1377,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
     DatabaseHandler& handler = *(psn_inst->handler());
 
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [psn_inst, driver_pin](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [psn_inst, driver_pin](BufferTree* a, BufferTree* b) -> bool {
                   float a_delay = psn_inst->handler()->gateDelay(
                       driver_pin, a->totalCapacitance());
                   float a_slack = a->totalRequiredOrSlew() - a_delay;
@@ -985,7 +1391,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
 
     float                       max_slack     = -1E+30F;
     float                       max_cost      = -1E+30F;
-    std::shared_ptr<BufferTree> max_tree      = nullptr;
+    BufferTree*                 max_tree      = nullptr;
     auto                        inst          = handler.instance(driver_pin);
     auto                        original_lib  = handler.libraryCell(inst);
     auto                        original_cost = handler.area(original_lib);
@@ -997,7 +1403,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
     float orig_penalty  = handler.bufferChainDelayPenalty(orig_max_cap) +
                          area_penalty * handler.area(original_lib);
     std::sort(original_libs.begin(), original_libs.end(),
-              [handler](LibraryCell* a, LibraryCell* b) -> bool {
+              [&handler](LibraryCell* a, LibraryCell* b) -> bool {
                   return handler.area(a) > handler.area(b);
               });
 
@@ -1076,7 +1482,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
             }
         }
     }
-    return max_tree;
+    return arena_->share(max_tree);
 }
 
 std::shared_ptr<BufferTree>
@@ -1088,8 +1494,7 @@ BufferSolution::optimalTimerlessDriverTree(Psn*          psn_inst,
         return nullptr;
     }
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [](BufferTree* a, BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
     float slew_limit = psn_inst->handler()->pinSlewLimit(driver_pin);
@@ -1102,10 +1507,10 @@ BufferSolution::optimalTimerlessDriverTree(Psn*          psn_inst,
             isLess(tr->totalRequiredOrSlew(), slew_limit, 1E-6F) &&
             !tr->hasDownstreamSlewViolation(psn_inst, slew_limit, in_slew))
         {
-            return tr;
+            return arena_->share(tr);
         }
     }
-    return buffer_trees_[0];
+    return arena_->share(buffer_trees_[0]);
 }
 std::shared_ptr<BufferTree>
 BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
@@ -1118,8 +1523,7 @@ BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
     }
 
     std::stable_sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [psn_inst, driver_pin](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [psn_inst, driver_pin](BufferTree* a, BufferTree* b) -> bool {
                   float a_delay = psn_inst->handler()->gateDelay(
                       driver_pin, a->totalCapacitance());
                   float a_slack = a->totalRequiredOrSlew() - a_delay;
@@ -1131,15 +1535,15 @@ BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
                           a->cost() < b->cost());
               });
 
-    float                       max_slack = -1E+30F;
-    std::shared_ptr<BufferTree> max_tree  = nullptr;
+    float       max_slack = -1E+30F;
+    BufferTree* max_tree  = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (tree->polarity())
         {
             if (inverted_sol == nullptr)
             {
-                inverted_sol = tree;
+                inverted_sol = arena_->share(tree);
             }
             continue;
         }
@@ -1158,7 +1562,7 @@ BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
             break; // Already sorted, no need to continue searching.
         }
     }
-    return max_tree;
+    return arena_->share(max_tree);
 }
 std::shared_ptr<BufferTree>
 BufferSolution::optimalCapacitanceTree(
@@ -1171,12 +1575,11 @@ BufferSolution::optimalCapacitanceTree(
     }
 
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [](BufferTree* a, BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree = nullptr;
+    BufferTree* max_tree = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (tree->totalCapacitance() < cap_limit)
@@ -1185,7 +1588,7 @@ BufferSolution::optimalCapacitanceTree(
             break;
         }
     }
-    return max_tree;
+    return arena_->share(max_tree);
 }
 std::shared_ptr<BufferTree>
 BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
@@ -1199,12 +1602,11 @@ BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
     DatabaseHandler& handler = *(psn_inst->handler());
 
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [](BufferTree* a, BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree = nullptr;
+    BufferTree* max_tree = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (handler.slew(handler.libraryPin(driver_pin),
@@ -1214,7 +1616,7 @@ BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
             break;
         }
     }
-    return max_tree;
+    return arena_->share(max_tree);
 }
 
 std::shared_ptr<BufferTree>
@@ -1229,22 +1631,21 @@ BufferSolution::optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
     DatabaseHandler& handler = *(psn_inst->handler());
 
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [](BufferTree* a, BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree  = nullptr;
-    float                       max_slack = -1E+30F;
-    size_t                      i         = 0;
-    std::shared_ptr<BufferTree> second_best;
+    BufferTree* max_tree    = nullptr;
+    float       max_slack   = -1E+30F;
+    size_t      i           = 0;
+    BufferTree* second_best = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (tree->polarity())
         {
             if (inverted_sol == nullptr)
             {
-                inverted_sol = tree;
+                inverted_sol = arena_->share(tree);
             }
             continue;
         }
@@ -1275,7 +1676,7 @@ BufferSolution::optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
         }
         i++;
     }
-    return max_tree == nullptr ? second_best : max_tree;
+    return arena_->share(max_tree == nullptr ? second_best : max_tree);
 }
 
 bool
@@ -1313,113 +1714,154 @@ BufferSolution::isGreaterOrEqual(float first, float second, float threshold)
             threshold * std::max(std::abs(first), std::abs(second)));
 }
 
+void
+BufferSolution::paretoSweep(std::vector<PruneCandidate>& candidates,
+                            float x_threshold, float y_threshold,
+                            bool strict_x)
+{
+    // Staircase of the survivors: y strictly decreases as x increases, so the
+    // minimum y over x <= bound is the last step at or before the bound.
+    std::map<float, float> stairs;
+    size_t                 index = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        auto& cand = candidates[i];
+        float bound =
+            strict_x ? cand.x - x_threshold * std::abs(cand.x)
+                     : cand.x + x_threshold * std::abs(cand.x);
+        auto step = strict_x ? stairs.lower_bound(bound)
+                             : stairs.upper_bound(bound);
+        if (step != stairs.begin() &&
+            !isLess(cand.y, std::prev(step)->second, y_threshold))
+        {
+            continue;
+        }
+        candidates[index++] = cand;
+
+        auto next = stairs.upper_bound(cand.x);
+        if (next != stairs.begin() && std::prev(next)->second <= cand.y)
+        {
+            continue;
+        }
+        stairs[cand.x] = cand.y;
+        while (next != stairs.end() && next->second >= cand.y)
+        {
+            next = stairs.erase(next);
+        }
+    }
+    candidates.resize(index);
+}
+void
+BufferSolution::squeeze(std::vector<PruneCandidate>& candidates)
+{
+    std::sort(candidates.begin(), candidates.end(),
+              [](const PruneCandidate& a, const PruneCandidate& b) -> bool {
+                  return a.capacitance < b.capacitance ||
+                         (a.capacitance == b.capacitance &&
+                          a.required > b.required);
+              });
+    // A candidate lying under the chord of its neighbors is never better than
+    // both of them for any linear upstream resistance, so it can be dropped
+    // unless it is cheaper than both.
+    size_t index = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        auto& cand = candidates[i];
+        while (index >= 2)
+        {
+            auto& first  = candidates[index - 2];
+            auto& middle = candidates[index - 1];
+            if (!(cand.capacitance > first.capacitance) ||
+                middle.cost < std::max(first.cost, cand.cost) ||
+                (middle.required - first.required) *
+                        (cand.capacitance - first.capacitance) >
+                    (cand.required - first.required) *
+                        (middle.capacitance - first.capacitance))
+            {
+                break;
+            }
+            index--;
+        }
+        candidates[index++] = cand;
+    }
+    candidates.resize(index);
+}
+
 void
 BufferSolution::prune(Psn* psn_inst, LibraryCell* upstream_res_cell,
                       float       minimum_upstream_res_or_max_slew,
                       const float cap_prune_threshold,
-                      const float cost_prune_threshold)
+                      const float cost_prune_threshold,
+                      bool        squeeze_candidates)
 {
+    std::vector<PruneCandidate> candidates;
+    candidates.reserve(buffer_trees_.size());
+    auto by_key = [](const PruneCandidate& a,
+                     const PruneCandidate& b) -> bool { return a.key < b.key; };
     if (!isTimerless()) // Timing-driven
     {
-        // TODO Add squeeze pruning
         if (!upstream_res_cell)
         {
             PSN_LOG_WARN("Pruning without upstream resistance");
             return;
         }
 
-        std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [psn_inst, upstream_res_cell](const std::shared_ptr<BufferTree>& a,
-                      const std::shared_ptr<BufferTree>& b) -> bool {
-                      float left_req =
-                          a->bufferRequired(psn_inst, upstream_res_cell);
-                      float right_req =
-                          b->bufferRequired(psn_inst, upstream_res_cell);
-                      return left_req > right_req;
-                  });
-
-        size_t index = 0;
-        for (size_t i = 0; i < buffer_trees_.size(); i++)
+        // Sweep by decreasing required time seen through the upstream cell,
+        // dropping candidates with no less capacitance and no less cost.
+        for (auto& tree : buffer_trees_)
         {
-            index = i + 1;
-            for (size_t j = i + 1; j < buffer_trees_.size(); j++)
-            {
-                if (isLess(buffer_trees_[j]->totalCapacitance(),
-                           buffer_trees_[i]->totalCapacitance(),
-                           cap_prune_threshold) ||
-                    isLess(buffer_trees_[j]->cost(), buffer_trees_[i]->cost(),
-                           cost_prune_threshold))
-                {
-                    buffer_trees_[index++] = buffer_trees_[j];
-                }
-            }
-            buffer_trees_.resize(index);
+            float cap = tree->totalCapacitance();
+            float req = tree->totalRequiredOrSlew();
+            candidates.push_back(
+                {tree, -tree->bufferRequired(psn_inst, upstream_res_cell), cap,
+                 tree->cost(), cap, req, tree->cost()});
         }
+        std::sort(candidates.begin(), candidates.end(), by_key);
+        paretoSweep(candidates, cap_prune_threshold, cost_prune_threshold,
+                    false);
+
         if (minimum_upstream_res_or_max_slew)
         {
-            std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                      [](const std::shared_ptr<BufferTree>& a,
-                         const std::shared_ptr<BufferTree>& b) -> bool {
-                          return a->totalRequiredOrSlew() <
-                                 b->totalRequiredOrSlew();
-                      });
-
-            index = 0;
-            for (size_t i = 0; i < buffer_trees_.size(); i++)
+            // Sweep by increasing required time, dropping candidates whose
+            // extra capacitance costs more than it gains through the minimum
+            // upstream resistance.
+            for (auto& cand : candidates)
             {
-                index = i + 1;
-                for (size_t j = i + 1; j < buffer_trees_.size(); j++)
-                {
-                    if (isGreaterOrEqual(buffer_trees_[i]->totalCapacitance(),
-                                         buffer_trees_[j]->totalCapacitance(),
-                                         cap_prune_threshold) ||
-                        !((buffer_trees_[j]->totalRequiredOrSlew() -
-                           buffer_trees_[i]->totalRequiredOrSlew()) /
-                              (buffer_trees_[j]->totalCapacitance() -
-                               buffer_trees_[i]->totalCapacitance()) <
-                          minimum_upstream_res_or_max_slew))
-                    {
-                        buffer_trees_[index++] = buffer_trees_[j];
-                    }
-                }
-                buffer_trees_.resize(index);
+                cand.key = cand.required;
+                cand.x   = cand.capacitance;
+                cand.y   = minimum_upstream_res_or_max_slew * cand.capacitance -
+                         cand.required;
             }
+            std::sort(candidates.begin(), candidates.end(), by_key);
+            paretoSweep(candidates, cap_prune_threshold, 0.0F, true);
+        }
+        if (squeeze_candidates)
+        {
+            squeeze(candidates);
         }
     }
     else
     {
-        buffer_trees_.erase(
-            std::remove_if(buffer_trees_.begin(), buffer_trees_.end(),
-                           [minimum_upstream_res_or_max_slew, cap_prune_threshold](const std::shared_ptr<BufferTree>& t) -> bool {
-                               return isGreaterOrEqual(
-                                   t->totalRequiredOrSlew(),
-                                   minimum_upstream_res_or_max_slew,
-                                   cap_prune_threshold);
-                           }),
-            buffer_trees_.end());
-        std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [](const std::shared_ptr<BufferTree>& a,
-                     const std::shared_ptr<BufferTree>& b) -> bool {
-                      return a->cost() < b->cost();
-                  });
-        size_t index = 0;
-        for (size_t i = 0; i < buffer_trees_.size(); i++)
+        for (auto& tree : buffer_trees_)
         {
-            index = i + 1;
-            for (size_t j = i + 1; j < buffer_trees_.size(); j++)
+            float slew = tree->totalRequiredOrSlew();
+            if (isGreaterOrEqual(slew, minimum_upstream_res_or_max_slew,
+                                 cap_prune_threshold))
             {
-                if ((isLess(buffer_trees_[j]->totalRequiredOrSlew(),
-                            buffer_trees_[i]->totalRequiredOrSlew(),
-                            cap_prune_threshold) ||
-                     isLess(buffer_trees_[j]->totalCapacitance(),
-                            buffer_trees_[i]->totalCapacitance(),
-                            cap_prune_threshold)))
-                {
-                    buffer_trees_[index++] = buffer_trees_[j];
-                }
+                continue;
             }
-            buffer_trees_.resize(index);
+            float cap = tree->totalCapacitance();
+            candidates.push_back(
+                {tree, tree->cost(), slew, cap, cap, slew, tree->cost()});
         }
+        std::sort(candidates.begin(), candidates.end(), by_key);
+        paretoSweep(candidates, cap_prune_threshold, cap_prune_threshold,
+                    false);
+    }
+    buffer_trees_.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        buffer_trees_[i] = candidates[i].tree;
     }
 }
 void
@@ -1457,146 +1899,174 @@ TimerlessBufferSolution::TimerlessBufferSolution(
 std::shared_ptr<BufferSolution>
 BufferSolution::bottomUp(Psn* psn_inst, InstanceTerm* driver_pin,
                          SteinerPoint pt, SteinerPoint prev,
-                         std::shared_ptr<SteinerTree>          st_tree,
+                         std::shared_ptr<const SteinerTree>    st_tree,
                          std::unique_ptr<OptimizationOptions>& options)
 {
-    DatabaseHandler& handler = *(psn_inst->handler());
-    if (pt != SteinerNull)
-    {
-        auto  pt_pin        = st_tree->pin(pt);
-        float wire_length   = handler.dbuToMeters(st_tree->distance(prev, pt));
-        float wire_res      = wire_length * handler.resistancePerMicron();
-        float wire_cap      = wire_length * handler.capacitancePerMicron();
-        auto  location      = st_tree->location(pt);
-        auto  prev_location = st_tree->location(prev);
-        PSN_LOG_DEBUG("Bottomup Point: ({}, {})", location.getX(),
-                      location.getY());
-        PSN_LOG_TRACE("Prev: ({}, {})", prev_location.getX(),
-                      prev_location.getY());
-
-        if (pt_pin && handler.isLoad(pt_pin))
-        {
-            PSN_LOG_TRACE("{} ({}, {}) bottomUp leaf", handler.name(pt_pin),
-                          location.getX(), location.getY());
-            float                       cap = handler.pinCapacitance(pt_pin);
-            float                       req = handler.required(pt_pin);
-            std::shared_ptr<BufferTree> base_buffer_tree =
-                std::make_shared<BufferTree>(cap, req, 0, location,
-                                             handler.libraryPin(driver_pin),
-                                             pt_pin);
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>();
-            buff_sol->addTree(base_buffer_tree);
-
-            buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-
-            buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
-                                   options->buffer_lib, options->inverter_lib);
-            buff_sol->addUpstreamReferences(psn_inst, base_buffer_tree);
-
-            return buff_sol;
-        }
-        else if (!pt_pin)
-        {
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> left", location.getX(),
-                          location.getY());
-            auto left = bottomUp(psn_inst, driver_pin, st_tree->left(pt), pt,
-                                 st_tree, options);
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> right", location.getX(),
-                          location.getY());
-            auto right = bottomUp(psn_inst, driver_pin, st_tree->right(pt), pt,
-                                  st_tree, options);
-
-            PSN_LOG_TRACE("({}, {}) bottomUp merging", location.getX(),
-                          location.getY());
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>(
-                    psn_inst, left, right, location,
-                    options->buffer_lib[options->buffer_lib.size() / 2],
-                    options->minimum_upstream_resistance);
-
-            buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-            buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
-                                   options->buffer_lib, options->inverter_lib);
-
-            return buff_sol;
-        }
-    }
-    return nullptr;
+    return bottomUpTraversal(psn_inst, driver_pin, pt, prev, st_tree, options,
+                             nullptr);
 }
 
 std::shared_ptr<BufferSolution>
 BufferSolution::bottomUpWithResynthesis(
     Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt, SteinerPoint prev,
-    std::shared_ptr<SteinerTree>                          st_tree,
+    std::shared_ptr<const SteinerTree>                    st_tree,
     std::unique_ptr<OptimizationOptions>&                 options,
     std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals)
 {
+    return bottomUpTraversal(psn_inst, driver_pin, pt, prev, st_tree, options,
+                             &mapping_terminals);
+}
+
+std::shared_ptr<BufferSolution>
+BufferSolution::bottomUpTraversal(
+    Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt, SteinerPoint prev,
+    const std::shared_ptr<const SteinerTree>&             st_tree,
+    std::unique_ptr<OptimizationOptions>&                 options,
+    std::vector<std::shared_ptr<LibraryCellMappingNode>>* mapping_terminals)
+{
+    if (pt == SteinerNull)
+    {
+        return nullptr;
+    }
     DatabaseHandler& handler = *(psn_inst->handler());
-    if (pt != SteinerNull)
+    auto             arena   = std::make_shared<BufferTreeArena>();
+    SteinerPoint     root    = pt;
+
+    // The traversal stack and the per-point solution slots are kept per
+    // thread and reused between nets.
+    thread_local std::vector<BottomUpFrame>                   stack;
+    thread_local std::vector<std::shared_ptr<BufferSolution>> solutions;
+    stack.clear();
+    solutions.assign(std::max(st_tree->branchCount(), root + 1), nullptr);
+    stack.push_back({pt, prev, false});
+    CandidateBoundStats bound_stats;
+
+    while (!stack.empty())
     {
-        auto  pt_pin        = st_tree->pin(pt);
-        float wire_length   = handler.dbuToMeters(st_tree->distance(prev, pt));
+        auto frame  = stack.back();
+        auto pt_pin = st_tree->pin(frame.pt);
+        if (pt_pin && !handler.isLoad(pt_pin))
+        {
+            stack.pop_back();
+            continue;
+        }
+        if (!pt_pin && !frame.expanded)
+        {
+            stack.back().expanded = true;
+            SteinerPoint left_pt  = st_tree->left(frame.pt);
+            SteinerPoint right_pt = st_tree->right(frame.pt);
+            // Right is pushed first so that the left subtree is solved first
+            if (right_pt != SteinerNull)
+            {
+                stack.push_back({right_pt, frame.pt, false});
+            }
+            if (left_pt != SteinerNull)
+            {
+                stack.push_back({left_pt, frame.pt, false});
+            }
+            continue;
+        }
+        stack.pop_back();
+
+        float wire_length =
+            handler.dbuToMeters(st_tree->distance(frame.prev, frame.pt));
         float wire_res      = wire_length * handler.resistancePerMicron();
         float wire_cap      = wire_length * handler.capacitancePerMicron();
-        auto  location      = st_tree->location(pt);
-        auto  prev_location = st_tree->location(prev);
+        auto  location      = st_tree->location(frame.pt);
+        auto  prev_location = st_tree->location(frame.prev);
         PSN_LOG_DEBUG("Bottomup Point: ({}, {})", location.getX(),
                       location.getY());
         PSN_LOG_TRACE("Prev: ({}, {})", prev_location.getX(),
                       prev_location.getY());
 
-        if (pt_pin && handler.isLoad(pt_pin))
+        std::shared_ptr<BufferSolution> buff_sol;
+        BufferTree*                     base_buffer_tree = nullptr;
+        bool                            pass_through     = false;
+        if (pt_pin)
         {
             PSN_LOG_TRACE("{} ({}, {}) bottomUp leaf", handler.name(pt_pin),
                           location.getX(), location.getY());
-            float                       cap = handler.pinCapacitance(pt_pin);
-            float                       req = handler.required(pt_pin);
-            std::shared_ptr<BufferTree> base_buffer_tree =
-                std::make_shared<BufferTree>(cap, req, 0, location,
-                                             handler.libraryPin(driver_pin),
-                                             pt_pin);
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>();
+            float cap        = handler.pinCapacitance(pt_pin);
+            float req        = handler.required(pt_pin);
+            base_buffer_tree = arena->create<BufferTree>(
+                cap, req, 0, location, handler.libraryPin(driver_pin), pt_pin);
+            buff_sol = std::make_shared<BufferSolution>(
+                BufferMode::TimingDriven, arena);
             buff_sol->addTree(base_buffer_tree);
-
-            buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-
-            buff_sol->addLeafTreesWithResynthesis(
-                psn_inst, driver_pin, prev_location, options->buffer_lib,
-                options->inverter_lib, mapping_terminals);
-            buff_sol->addUpstreamReferences(psn_inst, base_buffer_tree);
-
-            return buff_sol;
         }
-        else if (!pt_pin)
+        else
         {
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> left", location.getX(),
-                          location.getY());
-            auto left = bottomUp(psn_inst, driver_pin, st_tree->left(pt), pt,
-                                 st_tree, options);
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> right", location.getX(),
-                          location.getY());
-            auto right = bottomUp(psn_inst, driver_pin, st_tree->right(pt), pt,
-                                  st_tree, options);
-
-            PSN_LOG_TRACE("({}, {}) bottomUp merging", location.getX(),
-                          location.getY());
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>(
+            SteinerPoint left_pt  = st_tree->left(frame.pt);
+            SteinerPoint right_pt = st_tree->right(frame.pt);
+            std::shared_ptr<BufferSolution> left, right;
+            if (left_pt != SteinerNull)
+            {
+                left.swap(solutions[left_pt]);
+            }
+            if (right_pt != SteinerNull)
+            {
+                right.swap(solutions[right_pt]);
+            }
+            if (!left || !right)
+            {
+                // Nothing to merge with a missing branch, the child trees keep
+                // their wire up to this point
+                buff_sol = left ? left : right;
+                if (!buff_sol)
+                {
+                    continue;
+                }
+                pass_through = true;
+            }
+            else
+            {
+                PSN_LOG_TRACE("({}, {}) bottomUp merging", location.getX(),
+                              location.getY());
+                buff_sol = std::make_shared<BufferSolution>(
                     psn_inst, left, right, location,
                     options->buffer_lib[options->buffer_lib.size() / 2],
-                    options->minimum_upstream_resistance);
+                    options->minimum_upstream_resistance,
+                    BufferMode::TimingDriven, options->squeeze_candidates);
+            }
+        }
 
+        if (pass_through)
+        {
+            buff_sol->extendWireDelayAndCapacitance(wire_res, wire_cap);
+        }
+        else
+        {
             buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
+        }
+        // Resynthesized trees are only added at the first point, its subtrees
+        // use the regular buffer library.
+        if (mapping_terminals && frame.pt == root)
+        {
             buff_sol->addLeafTreesWithResynthesis(
                 psn_inst, driver_pin, prev_location, options->buffer_lib,
-                options->inverter_lib, mapping_terminals);
-
-            return buff_sol;
+                options->inverter_lib, *mapping_terminals);
         }
+        else
+        {
+            buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
+                                   options->buffer_lib, options->inverter_lib);
+        }
+        if (base_buffer_tree)
+        {
+            buff_sol->addUpstreamReferences(psn_inst, base_buffer_tree);
+        }
+        buff_sol->boundCandidates(
+            options->max_candidates, options->candidate_required_grid,
+            options->candidate_capacitance_grid, bound_stats);
+        solutions[frame.pt] = buff_sol;
+    }
+    auto buff_sol = solutions[root];
+    solutions.clear();
+    if (buff_sol)
+    {
+        buff_sol->bound_stats_ = bound_stats;
     }
-    return nullptr;
+    return buff_sol;
 }
 
 void
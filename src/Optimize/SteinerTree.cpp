@@ -31,39 +31,394 @@
 
 #include "OpenPhySyn/Optimize/SteinerTree.hpp"
 #include <algorithm>
+#include <cstdlib>
+#include <numeric>
 #include "OpenPhySyn/Psn/Psn.hpp"
 #include "PsnException/SteinerException.hpp"
+#ifdef TF_ENABLED
+#include <taskflow/taskflow.hpp>
+#endif
 namespace psn
 {
+std::atomic<size_t> SteinerTree::flute_nets_(0);
+std::atomic<size_t> SteinerTree::spanning_tree_nets_(0);
+std::atomic<size_t> SteinerTree::max_spanning_tree_degree_(0);
+
 std::unique_ptr<SteinerTree>
 SteinerTree::create(Net* net, Psn* psn_inst, int flute_accuracy)
+{
+    NetPins net_pins;
+    gatherPins(net, psn_inst, net_pins);
+    return build(net_pins, psn_inst, flute_accuracy);
+}
+
+std::vector<std::unique_ptr<SteinerTree>>
+SteinerTree::createMany(const std::vector<Net*>& nets, Psn* psn_inst,
+                        int flute_accuracy, int threads)
+{
+    // The database is only queried here, the workers build the trees from
+    // the gathered pins
+    std::vector<NetPins> net_pins(nets.size());
+    for (size_t i = 0; i < nets.size(); i++)
+    {
+        gatherPins(nets[i], psn_inst, net_pins[i]);
+    }
+    std::vector<std::unique_ptr<SteinerTree>> trees(nets.size());
+    auto build_tree = [&](int index) {
+        trees[index] = build(net_pins[index], psn_inst, flute_accuracy);
+    };
+#ifdef TF_ENABLED
+    if (threads > 1 && nets.size() > 1)
+    {
+        tf::Executor executor(threads);
+        tf::Taskflow taskflow;
+        taskflow.parallel_for(0, static_cast<int>(nets.size()), 1,
+                              build_tree);
+        executor.run(taskflow).wait();
+        return trees;
+    }
+#endif
+    for (size_t i = 0; i < nets.size(); i++)
+    {
+        build_tree(i);
+    }
+    return trees;
+}
+
+void
+SteinerTree::gatherPins(Net* net, Psn* psn_inst, NetPins& net_pins)
 {
     DatabaseHandler& handler = *(psn_inst->handler());
-    auto             pins    = handler.connectedPins(net);
+    net_pins.net             = net;
+    net_pins.pins            = handler.connectedPins(net);
+    net_pins.driver          = -1;
+    size_t pin_count         = net_pins.pins.size();
+    net_pins.x.resize(pin_count);
+    net_pins.y.resize(pin_count);
+    net_pins.capacitance.resize(pin_count);
+    for (size_t i = 0; i < pin_count; i++)
+    {
+        auto  pin               = net_pins.pins[i];
+        Point loc               = handler.location(pin);
+        net_pins.x[i]           = loc.x();
+        net_pins.y[i]           = loc.y();
+        net_pins.capacitance[i] = handler.pinCapacitance(pin);
+        if (net_pins.driver < 0 && handler.isDriver(pin))
+        {
+            net_pins.driver = i;
+        }
+    }
+}
 
+std::unique_ptr<SteinerTree>
+SteinerTree::build(NetPins& net_pins, Psn* psn_inst, int flute_accuracy)
+{
     std::unique_ptr<SteinerTree> tree(nullptr);
-    unsigned int                 pin_count = pins.size();
+    unsigned int                 pin_count = net_pins.pins.size();
     if (pin_count >= 2)
     {
-        FLUTE_DTYPE* x = new FLUTE_DTYPE[pin_count];
-        FLUTE_DTYPE* y = new FLUTE_DTYPE[pin_count];
-        for (unsigned int i = 0; i < pin_count; i++)
+        int degree_limit = psn_inst->handler()->steinerFluteDegreeLimit();
+        if (degree_limit > 0 && pin_count > (unsigned int)degree_limit)
+        {
+            int         root          = std::max(net_pins.driver, 0);
+            Flute::Tree spanning_tree = spanningTree(
+                pin_count, net_pins.x.data(), net_pins.y.data(), root);
+            tree.reset(new SteinerTree(spanning_tree, net_pins, psn_inst));
+            tree->method_ = SteinerMethod::SpanningTree;
+            spanning_tree_nets_++;
+            size_t max_degree = max_spanning_tree_degree_;
+            while (pin_count > max_degree &&
+                   !max_spanning_tree_degree_.compare_exchange_weak(
+                       max_degree, pin_count))
+            {
+            }
+        }
+        else
         {
-            auto  pin = pins[i];
-            Point loc = handler.location(pin);
-            x[i]      = loc.x();
-            y[i]      = loc.y();
+            psn_inst->ensureFluteInitialized();
+            Flute::Tree flute_tree =
+                Flute::flute(pin_count, net_pins.x.data(), net_pins.y.data(),
+                             flute_accuracy);
+            tree.reset(new SteinerTree(flute_tree, net_pins, psn_inst));
+            flute_nets_++;
         }
-        Flute::Tree flute_tree = Flute::flute(pin_count, x, y, flute_accuracy);
+        tree->net_ = net_pins.net;
+    }
+    return tree;
+}
 
-        tree.reset(new SteinerTree(flute_tree, pins, psn_inst));
-        tree->net_ = net;
+Flute::Tree
+SteinerTree::spanningTree(int degree, FLUTE_DTYPE* x, FLUTE_DTYPE* y, int root)
+{
+    const int nearest_neighbors = 8;
+    const int refinement_passes = 2;
+
+    // Kruskal's minimum spanning tree over the nearest neighbor edges, the
+    // x-ordered chain keeps the graph connected
+    std::vector<std::pair<DefDbu, std::pair<int, int>>> edges;
+    nearestNeighborEdges(degree, x, y, nearest_neighbors, edges);
+    std::vector<int> order(degree);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) -> bool {
+        return x[a] < x[b] || (x[a] == x[b] && y[a] < y[b]);
+    });
+    for (int i = 0; i + 1 < degree; i++)
+    {
+        int a = order[i], b = order[i + 1];
+        edges.push_back(std::make_pair(
+            abs(x[a] - x[b]) + abs(y[a] - y[b]), std::make_pair(a, b)));
+    }
+    std::sort(edges.begin(), edges.end());
 
-        delete[] x;
-        delete[] y;
+    std::vector<int> sets(degree);
+    std::iota(sets.begin(), sets.end(), 0);
+    auto find_set = [&sets](int a) -> int {
+        while (sets[a] != a)
+        {
+            sets[a] = sets[sets[a]];
+            a       = sets[a];
+        }
+        return a;
+    };
+    std::vector<std::vector<int>> adjacent(degree);
+    for (auto& edge : edges)
+    {
+        int a = edge.second.first, b = edge.second.second;
+        int a_set = find_set(a), b_set = find_set(b);
+        if (a_set != b_set)
+        {
+            sets[a_set] = b_set;
+            adjacent[a].push_back(b);
+            adjacent[b].push_back(a);
+        }
+    }
+
+    // Breadth-first order from the driver
+    std::vector<int> bfs_order(1, root);
+    std::vector<int> parent(degree, -1);
+    parent[root] = root;
+    for (size_t i = 0; i < bfs_order.size(); i++)
+    {
+        for (auto& adj : adjacent[bfs_order[i]])
+        {
+            if (parent[adj] < 0)
+            {
+                parent[adj] = bfs_order[i];
+                bfs_order.push_back(adj);
+            }
+        }
+    }
+
+    // Pins are leaves in the Flute layout: each pin and its children subtrees
+    // are chained through Steiner points at the pin location, farthest from
+    // the parent first. Every pin adds one Steiner point per child and the
+    // driver one less, giving the expected degree - 2 points.
+    int         point_count = 2 * degree - 2;
+    Flute::Tree tree;
+    tree.deg    = degree;
+    tree.length = 0;
+    tree.branch =
+        (Flute::Branch*)malloc(point_count * sizeof(Flute::Branch));
+    for (int i = 0; i < degree; i++)
+    {
+        tree.branch[i].x = x[i];
+        tree.branch[i].y = y[i];
+        tree.branch[i].n = i;
+    }
+    std::vector<int> subtree_top(degree);
+    std::vector<int> items;
+    int              next_point = degree;
+    for (int i = bfs_order.size() - 1; i >= 0; i--)
+    {
+        int pt = bfs_order[i];
+        int up = parent[pt];
+        items.clear();
+        if (pt != root)
+        {
+            items.push_back(pt);
+        }
+        for (auto& adj : adjacent[pt])
+        {
+            if (adj != up)
+            {
+                items.push_back(subtree_top[adj]);
+            }
+        }
+        auto parent_distance = [&](int item) -> DefDbu {
+            return abs(tree.branch[item].x - x[up]) +
+                   abs(tree.branch[item].y - y[up]);
+        };
+        std::sort(items.begin(), items.end(), [&](int a, int b) -> bool {
+            return parent_distance(a) > parent_distance(b);
+        });
+        int top = items[0];
+        for (size_t j = 1; j < items.size(); j++)
+        {
+            int steiner_pt             = next_point++;
+            tree.branch[steiner_pt].x  = x[pt];
+            tree.branch[steiner_pt].y  = y[pt];
+            tree.branch[steiner_pt].n  = steiner_pt;
+            tree.branch[top].n         = steiner_pt;
+            tree.branch[items[j]].n    = steiner_pt;
+            top                        = steiner_pt;
+        }
+        subtree_top[pt] = top;
+    }
+    tree.branch[subtree_top[root]].n = root;
+
+    // Each Steiner point has three neighbors, their coordinate-wise median
+    // is its optimal location
+    std::vector<std::vector<int>> neighbors(point_count);
+    for (int i = 0; i < point_count; i++)
+    {
+        int n = tree.branch[i].n;
+        if (n != i)
+        {
+            neighbors[i].push_back(n);
+            neighbors[n].push_back(i);
+        }
+    }
+    auto median = [](FLUTE_DTYPE a, FLUTE_DTYPE b, FLUTE_DTYPE c) {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    };
+    for (int pass = 0; pass < refinement_passes; pass++)
+    {
+        for (int i = degree; i < point_count; i++)
+        {
+            auto& first  = tree.branch[neighbors[i][0]];
+            auto& second = tree.branch[neighbors[i][1]];
+            auto& third  = tree.branch[neighbors[i][2]];
+            tree.branch[i].x = median(first.x, second.x, third.x);
+            tree.branch[i].y = median(first.y, second.y, third.y);
+        }
+    }
+    for (int i = 0; i < point_count; i++)
+    {
+        auto& branch_pt = tree.branch[i];
+        auto& next_pt   = tree.branch[branch_pt.n];
+        tree.length +=
+            abs(branch_pt.x - next_pt.x) + abs(branch_pt.y - next_pt.y);
     }
     return tree;
 }
+
+void
+SteinerTree::nearestNeighborEdges(
+    int degree, FLUTE_DTYPE* x, FLUTE_DTYPE* y, int neighbors,
+    std::vector<std::pair<DefDbu, std::pair<int, int>>>& edges)
+{
+    // Implicit k-d tree: the middle element of each range is its median
+    // along the axis, alternating with the depth
+    struct KdRange
+    {
+        int    begin;
+        int    end;
+        bool   split_y;
+        DefDbu bound; // Lower bound of the distance to the range
+    };
+    std::vector<int> points(degree);
+    std::iota(points.begin(), points.end(), 0);
+    std::vector<KdRange> ranges(1, {0, degree, false, 0});
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        KdRange range = ranges[i];
+        if (range.end - range.begin <= 1)
+        {
+            continue;
+        }
+        int middle = (range.begin + range.end) / 2;
+        std::nth_element(points.begin() + range.begin, points.begin() + middle,
+                         points.begin() + range.end,
+                         [&](int a, int b) -> bool {
+                             return range.split_y ? y[a] < y[b] : x[a] < x[b];
+                         });
+        ranges.push_back({range.begin, middle, !range.split_y, 0});
+        ranges.push_back({middle + 1, range.end, !range.split_y, 0});
+    }
+
+    std::vector<std::pair<DefDbu, int>> nearest; // Max-heap on the distance
+    std::vector<KdRange>                stack;
+    for (int i = 0; i < degree; i++)
+    {
+        nearest.clear();
+        stack.clear();
+        stack.push_back({0, degree, false, 0});
+        while (!stack.empty())
+        {
+            KdRange range = stack.back();
+            stack.pop_back();
+            if (range.begin >= range.end ||
+                ((int)nearest.size() == neighbors &&
+                 range.bound >= nearest.front().first))
+            {
+                continue;
+            }
+            int middle = (range.begin + range.end) / 2;
+            int pt     = points[middle];
+            if (pt != i)
+            {
+                DefDbu distance = abs(x[i] - x[pt]) + abs(y[i] - y[pt]);
+                if ((int)nearest.size() < neighbors)
+                {
+                    nearest.push_back(std::make_pair(distance, pt));
+                    std::push_heap(nearest.begin(), nearest.end());
+                }
+                else if (distance < nearest.front().first)
+                {
+                    std::pop_heap(nearest.begin(), nearest.end());
+                    nearest.back() = std::make_pair(distance, pt);
+                    std::push_heap(nearest.begin(), nearest.end());
+                }
+            }
+            DefDbu  offset    = range.split_y ? y[i] - y[pt] : x[i] - x[pt];
+            KdRange low_side  = {range.begin, middle, !range.split_y,
+                                range.bound};
+            KdRange high_side = {middle + 1, range.end, !range.split_y,
+                                 range.bound};
+            // The near side is searched first
+            if (offset < 0)
+            {
+                high_side.bound = std::max(range.bound, -offset);
+                stack.push_back(high_side);
+                stack.push_back(low_side);
+            }
+            else
+            {
+                low_side.bound = std::max(range.bound, offset);
+                stack.push_back(low_side);
+                stack.push_back(high_side);
+            }
+        }
+        for (auto& neighbor : nearest)
+        {
+            edges.push_back(std::make_pair(
+                neighbor.first, std::make_pair(i, neighbor.second)));
+        }
+    }
+}
+
+SteinerStats
+SteinerTree::statistics()
+{
+    SteinerStats stats;
+    stats.flute_nets               = flute_nets_;
+    stats.spanning_tree_nets       = spanning_tree_nets_;
+    stats.max_spanning_tree_degree = max_spanning_tree_degree_;
+    return stats;
+}
+void
+SteinerTree::resetStatistics()
+{
+    flute_nets_               = 0;
+    spanning_tree_nets_       = 0;
+    max_spanning_tree_degree_ = 0;
+}
+SteinerMethod
+SteinerTree::method() const
+{
+    return method_;
+}
+
 bool
 SteinerTree::isPlaced() const
 {
@@ -79,16 +434,14 @@ SteinerTree::isPlaced() const
 SteinerBranch
 SteinerTree::branch(int index) const
 {
-    Flute::Branch& branch_pt1 = tree_.branch[index];
-    int            index2     = branch_pt1.n;
-    Flute::Branch& branch_pt2 = tree_.branch[index2];
-    Point          pt1        = Point(branch_pt1.x, branch_pt1.y);
-    Point          pt2        = Point(branch_pt2.x, branch_pt2.y);
-    int            pin_count  = pins_.size();
-    InstanceTerm*  pin1;
-    InstanceTerm*  pin2;
-    SteinerPoint   st_pt1 = SteinerNull;
-    SteinerPoint   st_pt2 = SteinerNull;
+    int           index2    = parent_[index];
+    Point         pt1       = Point(x_[index], y_[index]);
+    Point         pt2       = Point(x_[index2], y_[index2]);
+    int           pin_count = pins_.size();
+    InstanceTerm* pin1;
+    InstanceTerm* pin2;
+    SteinerPoint  st_pt1 = SteinerNull;
+    SteinerPoint  st_pt2 = SteinerNull;
     if (index < pin_count)
     {
         pin1   = pin(index);
@@ -110,61 +463,104 @@ SteinerTree::branch(int index) const
         st_pt2 = index2;
     }
 
-    int wire_length =
-        abs(branch_pt1.x - branch_pt2.x) + abs(branch_pt1.y - branch_pt2.y);
-    return SteinerBranch(pt1, pin1, st_pt1, pt2, pin2, st_pt2, wire_length);
+    return SteinerBranch(pt1, pin1, st_pt1, pt2, pin2, st_pt2,
+                         edge_length_[index]);
 }
 int
 SteinerTree::branchCount() const
 {
-    return tree_.deg * 2 - 2;
+    return parent_.size();
 }
 InstanceTerm*
 SteinerTree::pin(SteinerPoint pt) const
 {
     validatePoint(pt);
-    if (pt < (int)pins_.size())
-        return point_pin_map_[pt];
-    else
-        return nullptr;
+    return point_pin_[pt];
 }
 
 SteinerPoint
 SteinerTree::driverPoint() const
 {
-    for (unsigned int i = 0; i < pins_.size(); i++)
-    {
-        auto pin = this->pin(i);
-        if (psn_->handler()->isDriver(pin))
-            return i;
-    }
-    return SteinerNull;
+    return driver_;
 }
-SteinerTree::SteinerTree(Flute::Tree tree, std::vector<InstanceTerm*> pins,
+SteinerTree::SteinerTree(Flute::Tree tree, const NetPins& net_pins,
                          Psn* psn_inst)
-    : tree_(tree), pins_(pins), psn_(psn_inst)
+    : method_(SteinerMethod::Flute),
+      pins_(net_pins.pins),
+      driver_(SteinerNull),
+      psn_(psn_inst),
+      net_(nullptr)
 {
-    unsigned int pin_count = pins.size();
-    point_pin_map_.resize(pin_count);
-    std::unordered_map<Point, std::vector<InstanceTerm*>, PointHash, PointEqual>
-        pins_map;
-    for (unsigned int i = 0; i < pin_count; i++)
+    int pin_count   = pins_.size();
+    int point_count = tree.deg * 2 - 2;
+    x_.resize(point_count);
+    y_.resize(point_count);
+    parent_.resize(point_count);
+    edge_length_.resize(point_count);
+    for (int i = 0; i < point_count; i++)
+    {
+        Flute::Branch& branch_pt = tree.branch[i];
+        x_[i]                    = branch_pt.x;
+        y_[i]                    = branch_pt.y;
+        parent_[i]               = branch_pt.n;
+    }
+    Flute::free_tree(tree);
+    for (int i = 0; i < point_count; i++)
     {
-        auto  pin     = pins_[i];
-        Point loc     = psn_inst->handler()->location(pin);
-        pin_loc_[loc] = pin;
-        pins_map[loc].push_back(pin);
+        edge_length_[i] =
+            abs(x_[i] - x_[parent_[i]]) + abs(y_[i] - y_[parent_[i]]);
+    }
+
+    // Flute may reorder the pins, both sides are sorted by location and
+    // matched in order instead of hashing the locations
+    auto&            pin_x = net_pins.x;
+    auto&            pin_y = net_pins.y;
+    std::vector<int> input_order(pin_count);
+    std::vector<int> point_order(pin_count);
+    std::iota(input_order.begin(), input_order.end(), 0);
+    std::iota(point_order.begin(), point_order.end(), 0);
+    std::sort(input_order.begin(), input_order.end(),
+              [&](int a, int b) -> bool {
+                  return pin_x[a] < pin_x[b] ||
+                         (pin_x[a] == pin_x[b] && pin_y[a] < pin_y[b]);
+              });
+    std::sort(point_order.begin(), point_order.end(),
+              [&](int a, int b) -> bool {
+                  return x_[a] < x_[b] || (x_[a] == x_[b] && y_[a] < y_[b]);
+              });
+    point_pin_.resize(point_count, nullptr);
+    std::vector<float> point_capacitance(point_count, 0.0);
+    for (int i = 0; i < pin_count; i++)
+    {
+        SteinerPoint pt       = point_order[i];
+        point_pin_[pt]        = pins_[input_order[i]];
+        point_capacitance[pt] = net_pins.capacitance[input_order[i]];
+        if (input_order[i] == net_pins.driver)
+        {
+            driver_ = pt;
+        }
     }
-    for (unsigned int i = 0; i < pin_count; i++)
+
+    // Any pin sharing the location of the point
+    alias_.resize(point_count, nullptr);
+    for (int i = 0; i < point_count; i++)
     {
-        Flute::Branch&              branch_pt = tree_.branch[i];
-        std::vector<InstanceTerm*>& pin_locations =
-            pins_map[Point(branch_pt.x, branch_pt.y)];
-        auto pin = pin_locations.back();
-        pin_locations.pop_back();
-        point_pin_map_[i] = pin;
+        auto pin_it = std::lower_bound(
+            input_order.begin(), input_order.end(), i,
+            [&](int input_index, int pt) -> bool {
+                return pin_x[input_index] < x_[pt] ||
+                       (pin_x[input_index] == x_[pt] &&
+                        pin_y[input_index] < y_[pt]);
+            });
+        if (pin_it != input_order.end() && pin_x[*pin_it] == x_[i] &&
+            pin_y[*pin_it] == y_[i])
+        {
+            alias_[i] = pins_[*pin_it];
+        }
     }
+
     populateSides();
+    populateSubtrees(point_capacitance);
 }
 
 void
@@ -173,74 +569,114 @@ SteinerTree::populateSides()
     int branch_count = branchCount();
     left_.resize(branch_count, SteinerNull);
     right_.resize(branch_count, SteinerNull);
-    std::vector<SteinerPoint> adj1(branch_count, SteinerNull);
-    std::vector<SteinerPoint> adj2(branch_count, SteinerNull);
-    std::vector<SteinerPoint> adj3(branch_count, SteinerNull);
+    if (driver_ == SteinerNull)
+    {
+        return;
+    }
+    // Up to three neighbors per point
+    std::vector<SteinerPoint> adjacent(3 * branch_count, SteinerNull);
+    auto add_adjacent = [&adjacent](SteinerPoint pt, SteinerPoint adj) {
+        int k = 0;
+        while (k < 2 && adjacent[3 * pt + k] != SteinerNull)
+        {
+            k++;
+        }
+        adjacent[3 * pt + k] = adj;
+    };
     for (int i = 0; i < branch_count; i++)
     {
-        Flute::Branch& branch_pt = tree_.branch[i];
-        SteinerPoint   j         = branch_pt.n;
+        SteinerPoint j = parent_[i];
         if (j != i)
         {
-            if (adj1[i] == SteinerNull)
-                adj1[i] = j;
-            else if (adj2[i] == SteinerNull)
-                adj2[i] = j;
-            else
-                adj3[i] = j;
-
-            if (adj1[j] == SteinerNull)
-                adj1[j] = i;
-            else if (adj2[j] == SteinerNull)
-                adj2[j] = i;
-            else
-                adj3[j] = i;
+            add_adjacent(i, j);
+            add_adjacent(j, i);
         }
     }
 
-    SteinerPoint root     = driverPoint();
-    SteinerPoint root_adj = adj1[root];
-    left_[root]           = root_adj;
-    populateSides(root, root_adj, adj1, adj2, adj3);
-}
-
-void
-SteinerTree::populateSides(SteinerPoint from, SteinerPoint to,
-                           std::vector<SteinerPoint>& adj1,
-                           std::vector<SteinerPoint>& adj2,
-                           std::vector<SteinerPoint>& adj3)
-{
-    if (to >= (int)pins_.size())
+    // Depth-first from the driver, the explicit stack keeps large nets from
+    // exhausting the call stack
+    int          pin_count = pins_.size();
+    SteinerPoint root_adj  = adjacent[3 * driver_];
+    left_[driver_]         = root_adj;
+    std::vector<std::pair<SteinerPoint, SteinerPoint>> stack;
+    stack.push_back(std::make_pair(driver_, root_adj));
+    int visited = 0;
+    while (!stack.empty())
     {
-        SteinerPoint adj;
-        adj = adj1[to];
-        populateSides(from, to, adj, adj1, adj2, adj3);
-        adj = adj2[to];
-        populateSides(from, to, adj, adj1, adj2, adj3);
-        adj = adj3[to];
-        populateSides(from, to, adj, adj1, adj2, adj3);
+        SteinerPoint from = stack.back().first;
+        SteinerPoint to   = stack.back().second;
+        stack.pop_back();
+        if (to < pin_count)
+        {
+            continue;
+        }
+        if (++visited > branch_count)
+            throw SteinerException();
+        for (int k = 0; k < 3; k++)
+        {
+            SteinerPoint adj = adjacent[3 * to + k];
+            if (adj == from || adj == SteinerNull)
+            {
+                continue;
+            }
+            if (adj == to)
+                throw SteinerException();
+            if (left_[to] == SteinerNull)
+            {
+                left_[to] = adj;
+                stack.push_back(std::make_pair(to, adj));
+            }
+            else if (right_[to] == SteinerNull)
+            {
+                right_[to] = adj;
+                stack.push_back(std::make_pair(to, adj));
+            }
+        }
     }
 }
 
 void
-SteinerTree::populateSides(SteinerPoint from, SteinerPoint to, SteinerPoint adj,
-                           std::vector<SteinerPoint>& adj1,
-                           std::vector<SteinerPoint>& adj2,
-                           std::vector<SteinerPoint>& adj3)
+SteinerTree::populateSubtrees(const std::vector<float>& point_capacitance)
 {
-    if (adj != from && adj != SteinerNull)
+    int branch_count = branchCount();
+    subtree_length_.resize(branch_count, 0);
+    subtree_capacitance_.resize(branch_count, 0.0);
+    subtree_sinks_.resize(branch_count, 0);
+    if (driver_ == SteinerNull)
     {
-        if (adj == to)
-            throw SteinerException();
-        if (left_[to] == SteinerNull)
+        return;
+    }
+    order_.assign(1, driver_);
+    for (size_t i = 0; i < order_.size(); i++)
+    {
+        SteinerPoint pt = order_[i];
+        if (left_[pt] != SteinerNull)
+            order_.push_back(left_[pt]);
+        if (right_[pt] != SteinerNull)
+            order_.push_back(right_[pt]);
+    }
+    for (int i = order_.size() - 1; i >= 0; i--)
+    {
+        SteinerPoint pt = order_[i];
+        if (isLeaf(pt))
         {
-            left_[to] = adj;
-            populateSides(to, adj, adj1, adj2, adj3);
+            if (point_pin_[pt])
+            {
+                subtree_capacitance_[pt] = point_capacitance[pt];
+                subtree_sinks_[pt]       = 1;
+            }
+            continue;
         }
-        else if (right_[to] == SteinerNull)
+        for (auto child : {left_[pt], right_[pt]})
         {
-            right_[to] = adj;
-            populateSides(to, adj, adj1, adj2, adj3);
+            if (child != SteinerNull)
+            {
+                subtree_length_[pt] += subtree_length_[child] +
+                                       abs(x_[pt] - x_[child]) +
+                                       abs(y_[pt] - y_[child]);
+                subtree_capacitance_[pt] += subtree_capacitance_[child];
+                subtree_sinks_[pt] += subtree_sinks_[child];
+            }
         }
     }
 }
@@ -305,45 +741,72 @@ SteinerTree::totalLoad(float cap_per_micron) const
 float
 SteinerTree::subtreeLoad(float cap_per_micron, SteinerPoint pt) const
 {
-    DatabaseHandler& handler = *(psn_->handler());
+    if (pt == SteinerNull)
+    {
+        return 0;
+    }
+    return subtree_capacitance_[pt] + subtreeWirelength(pt) * cap_per_micron;
+}
 
+int
+SteinerTree::subtreeSinkCount(SteinerPoint pt) const
+{
     if (pt == SteinerNull)
     {
         return 0;
     }
-    SteinerPoint left_pt  = left(pt);
-    SteinerPoint right_pt = right(pt);
-    bool         isLeaf   = left_pt == SteinerNull && right_pt == SteinerNull;
+    return subtree_sinks_[pt];
+}
+
+SteinerTiming
+SteinerTree::wireTiming() const
+{
+    DatabaseHandler& handler = *(psn_->handler());
+    return wireTiming(handler.resistancePerMicron(),
+                      handler.capacitancePerMicron());
+}
 
-    if (isLeaf)
+SteinerTiming
+SteinerTree::wireTiming(float res_per_micron, float cap_per_micron) const
+{
+    const float   slew_factor = 2.1972246; // ln(9), 10% to 90% step response
+    SteinerTiming timing;
+    if (driver_ == SteinerNull)
     {
-        InstanceTerm* pt_pin = pin(pt);
-        return handler.pinCapacitance(pt_pin);
+        return timing;
     }
-    else
+    float              meters_per_dbu = psn_->handler()->dbuToMeters(1);
+    std::vector<float> delays(branchCount(), 0.0);
+    for (auto& pt : order_)
     {
-        float left_cap  = 0;
-        float right_cap = 0;
-        if (left_pt != SteinerNull)
+        for (auto child : {left_[pt], right_[pt]})
         {
-            float left_length = handler.dbuToMeters(distance(pt, left_pt));
-            left_cap          = subtreeLoad(cap_per_micron, left_pt) +
-                       (left_length * cap_per_micron);
+            if (child == SteinerNull)
+            {
+                continue;
+            }
+            float wire_length =
+                (abs(x_[pt] - x_[child]) + abs(y_[pt] - y_[child])) *
+                meters_per_dbu;
+            float wire_res = wire_length * res_per_micron;
+            float wire_cap = wire_length * cap_per_micron;
+            delays[child] =
+                delays[pt] + wire_res * (wire_cap / 2.0 +
+                                         subtreeLoad(cap_per_micron, child));
         }
-        if (right_pt != SteinerNull)
+        if (pt != driver_ && isLeaf(pt) && point_pin_[pt])
         {
-            float right_length = handler.dbuToMeters(distance(pt, right_pt));
-            right_cap          = subtreeLoad(cap_per_micron, right_pt) +
-                        (right_length * cap_per_micron);
+            timing.sinks.push_back(point_pin_[pt]);
+            timing.sink_delays.push_back(delays[pt]);
+            timing.sink_slews.push_back(slew_factor * delays[pt]);
         }
-
-        return left_cap + right_cap;
     }
+    timing.driver_load = subtreeLoad(cap_per_micron, driver_);
+    return timing;
 }
 
 SteinerTree::~SteinerTree()
 {
-    Flute::free_tree(tree_);
 }
 
 void
@@ -356,8 +819,7 @@ Point
 SteinerTree::location(SteinerPoint pt) const
 {
     validatePoint(pt);
-    Flute::Branch& branch_pt = tree_.branch[pt];
-    return Point(branch_pt.x, branch_pt.y);
+    return Point(x_[pt], y_[pt]);
 }
 
 SteinerPoint
@@ -393,10 +855,9 @@ SteinerTree::top() const
     return top;
 }
 InstanceTerm*
-SteinerTree::alias(SteinerPoint pt)
+SteinerTree::alias(SteinerPoint pt) const
 {
-    Flute::Branch& branch_pt = tree_.branch[pt];
-    return pin_loc_[Point(branch_pt.x, branch_pt.y)];
+    return alias_[pt];
 }
 
 float
@@ -416,37 +877,11 @@ SteinerTree::wirelength() const
 float
 SteinerTree::subtreeWirelength(SteinerPoint pt) const
 {
-    DatabaseHandler& handler = *(psn_->handler());
-
     if (pt == SteinerNull)
     {
         return 0.0;
     }
-    SteinerPoint left_pt  = left(pt);
-    SteinerPoint right_pt = right(pt);
-    bool         isLeaf   = left_pt == SteinerNull && right_pt == SteinerNull;
-
-    if (isLeaf)
-    {
-        return 0.0;
-    }
-    else
-    {
-        float left_wire  = 0.0;
-        float right_wire = 0.0;
-        if (left_pt != SteinerNull)
-        {
-            float left_segment = handler.dbuToMeters(distance(pt, left_pt));
-            left_wire          = subtreeWirelength(left_pt) + left_segment;
-        }
-        if (right_pt != SteinerNull)
-        {
-            float right_segment = handler.dbuToMeters(distance(pt, right_pt));
-            right_wire          = subtreeWirelength(right_pt) + right_segment;
-        }
-
-        return left_wire + right_wire;
-    }
+    return subtree_length_[pt] * psn_->handler()->dbuToMeters(1);
 }
 
 Net*
@@ -138,6 +138,36 @@ set_wire_rc(const char* layer_name)
     return Psn::instance().setWireRC(layer_name);
 }
 int
+set_parasitics_threads(int threads)
+{
+    if (threads < 1)
+    {
+        PSN_LOG_ERROR("Number of threads should be at least 1.");
+        return -1;
+    }
+#ifndef TF_ENABLED
+    if (threads > 1)
+    {
+        PSN_LOG_WARN("OpenPhySyn is built without cpp-taskflow, running "
+                     "with a single thread");
+        threads = 1;
+    }
+#endif
+    Psn::instance().handler()->setParasiticsThreads(threads);
+    return 1;
+}
+int
+set_steiner_flute_degree_limit(int limit)
+{
+    if (limit < 0)
+    {
+        PSN_LOG_ERROR("Degree limit should be non-negative.");
+        return -1;
+    }
+    Psn::instance().handler()->setSteinerFluteDegreeLimit(limit);
+    return 1;
+}
+int
 set_max_area(float area)
 {
     Psn::instance().handler()->setMaximumArea(area);
@@ -160,6 +190,12 @@ set_dont_use(std::vector<std::string> cell_names)
 {
     Psn::instance().handler()->setDontUse(cell_names);
 }
+int
+set_characterization_cache(const char* path)
+{
+    Psn::instance().handler()->setCharacterizationCache(path);
+    return 1;
+}
 
 bool
 has_design()
@@ -58,6 +58,8 @@ bool  has_transform(const char* transform_name);
 int   set_wire_rc(float res_per_micron, float cap_per_micron);
 int   set_wire_rc(const char* layer_name);
 int   set_max_area(float area);
+int   set_parasitics_threads(int threads);
+int   set_steiner_flute_degree_limit(int limit);
 float max_area();
 float core_area();
 int   link(const char* top_module);
@@ -66,6 +68,7 @@ int   set_log(const char* level);
 int   set_log_level(const char* level);
 int   set_log_pattern(const char* pattern);
 void  set_dont_use(std::vector<std::string> cell_names);
+int   set_characterization_cache(const char* path);
 bool  has_design();
 bool  has_liberty();
 std::vector<std::string> capacitance_violations();
@@ -78,7 +78,7 @@ using sta::tcl_inits;
 Psn* Psn::psn_instance_;
 bool Psn::is_initialized_ = false;
 
-Psn::Psn(Database* db) : db_(db), interp_(nullptr)
+Psn::Psn(Database* db) : db_(db), lazy_flute_(false), interp_(nullptr)
 {
     if (db_ == nullptr)
     {
@@ -101,15 +101,15 @@ Psn::initialize(Database* db, bool load_transforms, Tcl_Interp* interp,
     {
         psn_instance_->setupInterpreter(interp);
     }
-    if (init_flute)
-    {
-        psn_instance_->initializeFlute();
-    }
+    // Flute tables are decoded by the first Steiner tree query so sessions
+    // that never build one skip the cost
+    psn_instance_->lazy_flute_ = init_flute;
     setupLegalizer();
     is_initialized_ = true;
 }
 
-Psn::Psn(sta::DatabaseSta* sta) : sta_(sta), db_(nullptr), interp_(nullptr)
+Psn::Psn(sta::DatabaseSta* sta)
+    : sta_(sta), db_(nullptr), lazy_flute_(false), interp_(nullptr)
 {
     if (sta == nullptr)
     {
@@ -136,10 +136,7 @@ Psn::initialize(sta::DatabaseSta* sta, bool load_transforms, Tcl_Interp* interp,
         psn_instance_->setupInterpreter(interp, import_psn_namespace,
                                         print_psn_version, setup_sta_tcl);
     }
-    if (init_flute)
-    {
-        psn_instance_->initializeFlute();
-    }
+    psn_instance_->lazy_flute_ = init_flute;
 
     setupLegalizer();
     is_initialized_ = true;
@@ -185,6 +182,8 @@ Psn::readLib(const char* path)
     {
         liberty_ = reader.read(path);
         sta_->getDbNetwork()->readLibertyAfter(liberty_);
+        // The cached cell tables do not cover the new library cells
+        db_handler_->resetCache();
         if (liberty_)
         {
             return 1;
@@ -239,6 +238,10 @@ Psn::readLef(const char* path, bool import_library, bool import_tech)
         {
             return 0;
         }
+        if (library)
+        {
+            db_handler_->resetCache();
+        }
 
         return 1;
     }
@@ -452,7 +455,11 @@ Psn::runTransform(std::string transform_name, std::vector<std::string> args)
         {
 
             PSN_LOG_INFO("Invoking {} transform", transform_name);
+            // The netlist may have been edited through OpenSTA or OpenDB
+            // since the last transform
+            db_handler_->invalidateLevelDrivers();
             int rc = transforms_[transform_name]->run(this, args);
+            db_handler_->saveCharacterizationCache();
             PSN_LOG_INFO("Finished {} transform ({})", transform_name, rc);
             return rc;
         }
@@ -710,6 +717,8 @@ Psn::printCommands(bool raw_str)
         "violation\n"
         "transition_violations		Print pins with transition limit "
         "violation\n"
+        "set_characterization_cache	Save and reuse library "
+        "characterization results in a file\n"
         "set_log				Alias for "
         "set_log_level\n"
         "set_log_level			Set log level [trace, debug, info, "
@@ -717,6 +726,10 @@ Psn::printCommands(bool raw_str)
         "set_log_pattern			Set log printing pattern, "
         "refer to spdlog logger for pattern formats\n"
         "set_max_area			Set maximum design area\n"
+        "set_parasitics_threads		Set the number of threads used for "
+        "full-design parasitics extraction\n"
+        "set_steiner_flute_degree_limit	Set the maximum net degree routed "
+        "by Flute, 0 for no limit\n"
         "set_wire_rc			Set wire "
         "resistance/capacitance per micron, you can also specify technology "
         "layer\n"
@@ -970,7 +983,15 @@ Psn::clearDatabase()
 int
 Psn::initializeFlute()
 {
-    Flute::readLUT();
+    std::call_once(flute_init_flag_, []() { Flute::readLUT(); });
     return 1;
 }
+void
+Psn::ensureFluteInitialized()
+{
+    if (lazy_flute_)
+    {
+        initializeFlute();
+    }
+}
 } // namespace psn
\ No newline at end of file
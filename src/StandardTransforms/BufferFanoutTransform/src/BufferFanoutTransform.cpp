@@ -78,16 +78,14 @@ BufferFanoutTransform::buffer(Psn* psn_inst, int max_fanout,
     }
     LibraryTerm*      cell_in_pin  = *(buffer_input_pins.begin());
     LibraryTerm*      cell_out_pin = *(buffer_output_pins.begin());
-    auto              nets         = handler.nets();
     std::vector<Net*> high_fanout_nets;
-    for (auto& net : nets)
-    {
+    handler.forEachNet([&](Net* net) {
         if (!handler.isPrimary(net) &&
             handler.fanoutCount(net) > (unsigned int)max_fanout)
         {
             high_fanout_nets.push_back(net);
         }
-    }
+    });
     PSN_LOG_INFO("High fanout nets [{}]: ", high_fanout_nets.size());
     for (auto& net : high_fanout_nets)
     {
@@ -111,40 +111,11 @@ ConstantPropagationTransform::isTiedToConstant(Psn*          psn_inst,
                                                InstanceTerm* constant_term,
                                                bool          constant_val)
 {
-    DatabaseHandler&           handler  = *(psn_inst->handler());
-    Instance*                  inst     = handler.instance(constant_term);
-    std::vector<InstanceTerm*> in_pins  = handler.inputPins(inst);
-    InstanceTerm*              out_pin  = handler.outputPins(inst)[0];
-    int                        last_val = -1;
-    LibraryTerm* constant_library_term  = handler.libraryPin(constant_term);
-    int          in_pin_size            = in_pins.size();
-    int          premuts                = std::pow(2, in_pin_size - 1);
-    for (int i = 0; i < premuts; ++i)
-    {
-        std::unordered_map<LibraryTerm*, int> sim_vals;
-        sim_vals[constant_library_term] = constant_val;
-        int temp                        = i;
-        for (InstanceTerm* in_pin : in_pins)
-        {
-            if (in_pin == constant_term)
-            {
-                continue;
-            }
-            LibraryTerm* library_pin = handler.libraryPin(in_pin);
-            sim_vals[library_pin]    = temp & 1;
-            temp >>= 1;
-        }
-        int result = handler.evaluateFunctionExpression(out_pin, sim_vals);
-        if (last_val == -1)
-        {
-            last_val = result;
-        }
-        else if (result != last_val)
-        {
-            return -1;
-        }
-    }
-    return last_val;
+    DatabaseHandler& handler = *(psn_inst->handler());
+    Instance*        inst    = handler.instance(constant_term);
+    InstanceTerm*    out_pin = handler.outputPins(inst)[0];
+    return handler.cofactorValue(out_pin, handler.libraryPin(constant_term),
+                                 constant_val);
 }
 void
 ConstantPropagationTransform::propagateTieHiLoCell(
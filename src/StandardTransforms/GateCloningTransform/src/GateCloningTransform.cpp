@@ -85,7 +85,7 @@ GateCloningTransform::cloneTree(Psn* psn_inst, Instance* inst, float cap_factor,
     {
         return;
     }
-    std::unique_ptr<SteinerTree> tree = SteinerTree::create(net, psn_inst);
+    auto tree = handler.steinerTree(net);
     if (tree == nullptr)
     {
         return;
@@ -133,7 +133,7 @@ GateCloningTransform::cloneTree(Psn* psn_inst, Instance* inst, float cap_factor,
                       handler.name(cell));
         return;
     }
-    int fanout_count = handler.fanoutPins(net).size();
+    int fanout_count = handler.fanoutCount(net);
 
     if (fanout_count <= 1)
     {
@@ -161,8 +161,8 @@ GateCloningTransform::cloneTree(Psn* psn_inst, Instance* inst, float cap_factor,
     }
 }
 void
-GateCloningTransform::topDownClone(Psn*                          psn_inst,
-                                   std::unique_ptr<SteinerTree>& tree,
+GateCloningTransform::topDownClone(Psn* psn_inst,
+                                   std::shared_ptr<const SteinerTree>& tree,
                                    SteinerPoint k, SteinerPoint prev,
                                    float c_limit, LibraryCell* driver_cell)
 {
@@ -212,8 +212,8 @@ GateCloningTransform::topDownClone(Psn*                          psn_inst,
     }
 }
 void
-GateCloningTransform::topDownConnect(Psn*                          psn_inst,
-                                     std::unique_ptr<SteinerTree>& tree,
+GateCloningTransform::topDownConnect(Psn* psn_inst,
+                                     std::shared_ptr<const SteinerTree>& tree,
                                      SteinerPoint k, Net* net)
 {
     DatabaseHandler& handler = *(psn_inst->handler());
@@ -233,8 +233,8 @@ GateCloningTransform::topDownConnect(Psn*                          psn_inst,
     }
 }
 void
-GateCloningTransform::cloneInstance(Psn*                          psn_inst,
-                                    std::unique_ptr<SteinerTree>& tree,
+GateCloningTransform::cloneInstance(Psn* psn_inst,
+                                    std::shared_ptr<const SteinerTree>& tree,
                                     SteinerPoint k, SteinerPoint prev,
                                     LibraryCell* driver_cell)
 {
@@ -266,7 +266,7 @@ GateCloningTransform::cloneInstance(Psn*                          psn_inst,
     para_nets.insert(output_net);
     handler.calculateParasitics(clone_net);
 
-    int fanout_count = handler.fanoutPins(handler.net(output_pin)).size();
+    int fanout_count = handler.fanoutCount(handler.net(output_pin));
     if (fanout_count == 0)
     {
         handler.disconnectAll(clone_net);
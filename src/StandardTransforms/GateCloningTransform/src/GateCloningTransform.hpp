@@ -44,12 +44,12 @@ class GateCloningTransform : public PsnTransform
 private:
     void cloneTree(Psn* psn_inst, Instance* inst, float cap_factor,
                    bool clone_largest_only);
-    void topDownClone(Psn* psn_inst, std::unique_ptr<SteinerTree>& tree,
+    void topDownClone(Psn* psn_inst, std::shared_ptr<const SteinerTree>& tree,
                       SteinerPoint k, SteinerPoint prev, float c_limit,
                       LibraryCell* driver_cell);
-    void topDownConnect(Psn* psn_inst, std::unique_ptr<SteinerTree>& tree,
+    void topDownConnect(Psn* psn_inst, std::shared_ptr<const SteinerTree>& tree,
                         SteinerPoint k, Net* net);
-    void cloneInstance(Psn* psn_inst, std::unique_ptr<SteinerTree>& tree,
+    void cloneInstance(Psn* psn_inst, std::shared_ptr<const SteinerTree>& tree,
                        SteinerPoint k, SteinerPoint prev,
                        LibraryCell* driver_cell);
     int  net_index_;
@@ -44,6 +44,10 @@
 #include <limits>
 #include <sstream>
 
+#ifdef TF_ENABLED
+#include <taskflow/taskflow.hpp>
+#endif
+
 namespace psn
 {
 
@@ -58,76 +62,193 @@ RepairTimingTransform::RepairTimingTransform()
       transition_violations_(0),
       capacitance_violations_(0),
       current_area_(0.0),
-      saved_slack_(0.0)
+      saved_slack_(0.0),
+      memoized_repairs_(0)
 {
 }
 
 std::unordered_set<Instance*>
 RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                                  RepairTarget                          target,
-                                 std::unique_ptr<OptimizationOptions>& options)
+                                 std::unique_ptr<OptimizationOptions>& options,
+                                 std::shared_ptr<BufferSolution>       buff_sol)
 {
     DatabaseHandler& handler = *(psn_inst->handler());
-    if (handler.isTopLevel(pin))
+    auto             pin_net = handler.net(pin);
+    if (isMemoized(psn_inst, pin, target, options))
     {
-        PSN_LOG_DEBUG("Top-level");
-        PSN_LOG_WARN("Top-level");
+        memoized_repairs_++;
         return std::unordered_set<Instance*>();
     }
-    auto pin_net = handler.net(pin);
-
-    // Remove existing buffers if rip-up enabled
-    if (options->ripup_existing_buffer_max_levels)
+    int  edit_count    = getEditCount();
+    auto added_buffers = repairPinUncached(psn_inst, pin, target, options,
+                                           buff_sol);
+    if (pin_net && !options->ripup_existing_buffer_max_levels)
     {
-        std::unordered_set<Instance*> fanout_buff;
-        auto connected_insts = handler.fanoutInstances(pin_net);
-        for (auto& inst : connected_insts)
+        if (getEditCount() == edit_count)
         {
-            if (options->buffer_lib_set.count(handler.libraryCell(inst)))
-            {
-                fanout_buff.insert(inst);
-            }
+            // Nothing changed, so the fingerprint also matches the state
+            // the repair started from
+            unchanged_nets_[pin_net] =
+                netFingerprint(psn_inst, pin, target, options);
+        }
+        else
+        {
+            unchanged_nets_.erase(pin_net);
         }
-        handler.ripupBuffers(fanout_buff);
     }
+    return added_buffers;
+}
+
+bool
+RepairTimingTransform::isMemoized(Psn* psn_inst, InstanceTerm* pin,
+                                  RepairTarget                          target,
+                                  std::unique_ptr<OptimizationOptions>& options)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
+    auto             pin_net = handler.net(pin);
+    if (!pin_net || options->ripup_existing_buffer_max_levels)
+    {
+        return false;
+    }
+    auto cached = unchanged_nets_.find(pin_net);
+    return cached != unchanged_nets_.end() &&
+           cached->second == netFingerprint(psn_inst, pin, target, options);
+}
+
+size_t
+RepairTimingTransform::netFingerprint(
+    Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+    std::unique_ptr<OptimizationOptions>& options)
+{
+    // Required times are compared on a 1ps grid
+    const float required_quantum = 1E-12;
 
-    // Create the Steiner tree
-    pin_net      = handler.net(pin);
-    auto st_tree = SteinerTree::create(pin_net, psn_inst);
-    if (!st_tree)
+    DatabaseHandler& handler = *(psn_inst->handler());
+    auto             combine = [](size_t seed, size_t value) -> size_t {
+        return seed ^
+               (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    };
+    auto pointer_hash = std::hash<const void*>();
+    auto float_hash   = std::hash<float>();
+
+    size_t hash = combine(pointer_hash(pin), static_cast<size_t>(target));
+    hash = combine(hash, pointer_hash(handler.libraryCell(pin)));
+    auto driver_location = handler.location(pin);
+    hash = combine(hash, std::hash<int>()(driver_location.getX()));
+    hash = combine(hash, std::hash<int>()(driver_location.getY()));
+    hash = combine(hash, float_hash(handler.resistancePerMicron()));
+    hash = combine(hash, float_hash(handler.capacitancePerMicron()));
+    for (auto& cell : options->buffer_lib)
+    {
+        hash = combine(hash, pointer_hash(cell));
+    }
+    for (auto& cell : options->inverter_lib)
     {
-        if (handler.connectedPins(pin_net).size() >= 2)
+        hash = combine(hash, pointer_hash(cell));
+    }
+
+    // Sinks are combined independently of the net pin order
+    size_t sinks_hash = 0;
+    handler.forEachPin(handler.net(pin), [&](InstanceTerm* sink) {
+        if (sink == pin)
         {
-            PSN_LOG_ERROR("Failed to create steiner tree for {}",
-                          handler.name(pin));
+            return;
         }
+        auto   location  = handler.location(sink);
+        size_t sink_hash = combine(pointer_hash(sink),
+                                   pointer_hash(handler.libraryPin(sink)));
+        sink_hash        = combine(sink_hash, std::hash<int>()(location.getX()));
+        sink_hash        = combine(sink_hash, std::hash<int>()(location.getY()));
+        float required = handler.isLoad(sink) ? handler.required(sink) : 0.0;
+        if (std::isfinite(required))
+        {
+            sink_hash = combine(sink_hash,
+                                std::hash<long long>()(std::llround(
+                                    required / required_quantum)));
+        }
+        sinks_hash += combine(0, sink_hash);
+    });
+    return combine(hash, sinks_hash);
+}
+
+std::unordered_set<Instance*>
+RepairTimingTransform::repairPinUncached(
+    Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+    std::unique_ptr<OptimizationOptions>& options,
+    std::shared_ptr<BufferSolution>       buff_sol)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
+    if (handler.isTopLevel(pin))
+    {
+        PSN_LOG_DEBUG("Top-level");
+        PSN_LOG_WARN("Top-level");
         return std::unordered_set<Instance*>();
     }
+    auto pin_net = handler.net(pin);
 
     bool is_slack_repair = target == RepairTarget::RepairSlack;
     bool is_trans_repair = target == RepairTarget::RepairMaxTransition;
     bool is_cap_repair   = target == RepairTarget::RepairMaxCapacitance;
     bool is_fo_repair    = target == RepairTarget::RepairMaxFanout;
 
-    auto driver_point = st_tree->driverPoint();
-    auto driver_pin   = st_tree->pin(driver_point);
-    auto driver_cell  = handler.instance(pin);
+    auto driver_cell = handler.instance(pin);
+
+    psn::LibraryCell* replace_driver;
+
+    if (!buff_sol)
+    {
+        // Remove existing buffers if rip-up enabled
+        if (options->ripup_existing_buffer_max_levels)
+        {
+            std::unordered_set<Instance*> fanout_buff;
+            auto connected_insts = handler.fanoutInstances(pin_net);
+            for (auto& inst : connected_insts)
+            {
+                if (options->buffer_lib_set.count(handler.libraryCell(inst)))
+                {
+                    fanout_buff.insert(inst);
+                }
+            }
+            handler.ripupBuffers(fanout_buff);
+        }
+
+        // Create the Steiner tree
+        pin_net      = handler.net(pin);
+        auto st_tree = handler.steinerTree(pin_net);
+        if (!st_tree)
+        {
+            if (handler.connectedPins(pin_net).size() >= 2)
+            {
+                PSN_LOG_ERROR("Failed to create steiner tree for {}",
+                              handler.name(pin));
+            }
+            return std::unordered_set<Instance*>();
+        }
 
-    auto top_point = st_tree->top();
+        auto driver_point = st_tree->driverPoint();
+        auto driver_pin   = st_tree->pin(driver_point);
+        auto top_point    = st_tree->top();
 
-    std::shared_ptr<BufferSolution> buff_sol;
-    psn::LibraryCell*               replace_driver;
+        // 1. Construct candidate buffer trees without insertion (bottomUp
+        // only)
+        buff_sol = BufferSolution::bottomUp(psn_inst, driver_pin, top_point,
+                                            driver_point, std::move(st_tree),
+                                            options);
+    }
 
-    // 1. Construct candidate buffer trees without insertion (bottomUp only)
-    buff_sol =
-        BufferSolution::bottomUp(psn_inst, driver_pin, top_point, driver_point,
-                                 std::move(st_tree), options);
+    auto& net_bound_stats = buff_sol->boundStats();
+    bound_stats_.evaluated_candidates += net_bound_stats.evaluated_candidates;
+    bound_stats_.dropped_candidates += net_bound_stats.dropped_candidates;
+    bound_stats_.bounded_points += net_bound_stats.bounded_points;
+    bound_stats_.max_required_loss = std::max(
+        bound_stats_.max_required_loss, net_bound_stats.max_required_loss);
 
     std::unordered_set<Instance*> added_buffers;
     std::unordered_set<Net*>      affected_nets;
 
     // Pick the optimal solution
-    if (buff_sol->bufferTrees().size())
+    if (buff_sol->trees().size())
     {
         bool use_min_cost = false;
         if (options->minimum_cost) // Check if minimum cost tree should be
@@ -145,7 +266,7 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
         std::shared_ptr<BufferTree> buff_tree     = nullptr;
         std::shared_ptr<BufferTree> max_req_tree  = nullptr;
         std::shared_ptr<BufferTree> inv_buff_tree = nullptr;
-        auto                        no_buff_tree  = buff_sol->bufferTrees()[0];
+        auto                        no_buff_tree  = buff_sol->bufferTree(0);
         float                       old_delay =
             handler.gateDelay(pin, no_buff_tree->totalCapacitance());
         float old_slack = no_buff_tree->totalRequiredOrSlew() - old_delay;
@@ -203,11 +324,11 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                 float buff_tree_slack =
                     buff_tree->totalRequiredOrSlew() - buff_tree_delay;
 
-                for (size_t i = 1; i < buff_sol->bufferTrees().size() &&
+                for (size_t i = 1; i < buff_sol->trees().size() &&
                                    i < options->best_solution_threshold_range;
                      i++)
                 {
-                    auto& tr = buff_sol->bufferTrees()[i];
+                    auto  tr = buff_sol->bufferTree(i);
                     float tr_delay =
                         handler.gateDelay(pin, tr->totalCapacitance());
                     float tr_slack = tr->totalRequiredOrSlew() - tr_delay;
@@ -531,6 +652,146 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
     return added_buffers;
 }
 
+size_t
+RepairTimingTransform::buildBufferSolutions(
+    Psn* psn_inst, std::vector<InstanceTerm*>& driver_pins, size_t start,
+    RepairTarget target, std::set<Net*>& clock_nets,
+    std::unique_ptr<OptimizationOptions>& options,
+    std::unordered_map<InstanceTerm*, std::shared_ptr<BufferSolution>>&
+        solutions)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
+    solutions.clear();
+    if (options->ripup_existing_buffer_max_levels)
+    {
+        // Rip-up edits the net before the candidates are built
+        return driver_pins.size();
+    }
+
+    // Collect the violating pins in order until one of them shares a net with
+    // the batch, the edits of a pin (buffering, sizing and pin-swapping) only
+    // touch its own net and the nets driving its instance.
+    std::vector<InstanceTerm*> batch;
+    std::unordered_set<Net*>   batch_nets;
+    size_t                     end = start;
+    for (; end < driver_pins.size() &&
+           batch.size() < (size_t)options->parallel_batch_size;
+         end++)
+    {
+        auto pin     = driver_pins[end];
+        auto pin_net = handler.net(pin);
+        if (!pin_net || clock_nets.count(pin_net) ||
+            handler.isSpecial(pin_net) || handler.isTopLevel(pin))
+        {
+            continue;
+        }
+        if (unchanged_nets_.count(pin_net) &&
+            isMemoized(psn_inst, pin, target, options))
+        {
+            // repairPin skips it
+            continue;
+        }
+        bool is_violating = false;
+        if (target == RepairTarget::RepairMaxFanout)
+        {
+            is_violating = handler.violatesMaximumFanout(pin);
+        }
+        else
+        {
+            auto vio = handler.hasElectricalViolation(
+                pin, options->capacitance_pessimism_factor,
+                options->transition_pessimism_factor);
+            is_violating =
+                vio == ElectircalViolation::CapacitanceAndTransition ||
+                (target == RepairTarget::RepairMaxCapacitance &&
+                 vio == ElectircalViolation::Capacitance) ||
+                (target == RepairTarget::RepairMaxTransition &&
+                 vio == ElectircalViolation::Transition);
+        }
+        if (!is_violating)
+        {
+            continue;
+        }
+        std::vector<Net*> pin_nets({pin_net});
+        for (auto& fpin : handler.inputPins(handler.instance(pin)))
+        {
+            auto fanin_net = handler.net(fpin);
+            if (fanin_net)
+            {
+                pin_nets.push_back(fanin_net);
+            }
+        }
+        bool is_independent = true;
+        for (auto& net : pin_nets)
+        {
+            if (batch_nets.count(net))
+            {
+                is_independent = false;
+                break;
+            }
+        }
+        if (!is_independent)
+        {
+            break;
+        }
+        batch_nets.insert(pin_nets.begin(), pin_nets.end());
+        batch.push_back(pin);
+    }
+    if (!batch.size())
+    {
+        return end;
+    }
+
+    std::vector<Net*> nets;
+    for (auto& pin : batch)
+    {
+        nets.push_back(handler.net(pin));
+    }
+    // Steiner tree construction reads pin locations and connectivity from the
+    // network, which is not safe from the workers, so the trees are built
+    // before the batch starts.
+    auto trees = handler.steinerTrees(nets);
+    std::vector<std::shared_ptr<BufferSolution>> batch_solutions(batch.size());
+    auto build_solution = [&](int index) {
+        auto st_tree = trees[index];
+        if (!st_tree)
+        {
+            // Leave it to repairPin to report
+            return;
+        }
+        auto driver_point = st_tree->driverPoint();
+        auto driver_pin   = st_tree->pin(driver_point);
+        auto top_point    = st_tree->top();
+        batch_solutions[index] =
+            BufferSolution::bottomUp(psn_inst, driver_pin, top_point,
+                                     driver_point, std::move(st_tree), options);
+    };
+
+    PSN_LOG_DEBUG("Building buffer solutions for {} nets", batch.size());
+    handler.beginConcurrentQueries(nets);
+#ifdef TF_ENABLED
+    tf::Taskflow taskflow;
+    taskflow.parallel_for(0, static_cast<int>(batch.size()), 1,
+                          build_solution);
+    executor_->run(taskflow).wait();
+#else
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        build_solution(i);
+    }
+#endif
+    handler.endConcurrentQueries();
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch_solutions[i])
+        {
+            solutions[batch[i]] = batch_solutions[i];
+        }
+    }
+    return end;
+}
+
 int
 RepairTimingTransform::fixCapacitanceViolations(
     Psn* psn_inst, std::vector<InstanceTerm*>& driver_pins,
@@ -540,8 +801,18 @@ RepairTimingTransform::fixCapacitanceViolations(
     DatabaseHandler& handler         = *(psn_inst->handler());
     auto             clock_nets      = handler.clockNets();
     int              last_edit_count = getEditCount();
-    for (auto& pin : driver_pins)
+    size_t           batch_end       = 0;
+    std::unordered_map<InstanceTerm*, std::shared_ptr<BufferSolution>>
+        solutions;
+    for (size_t i = 0; i < driver_pins.size(); i++)
     {
+        auto pin = driver_pins[i];
+        if (options->parallel_threads > 1 && i == batch_end)
+        {
+            batch_end = buildBufferSolutions(
+                psn_inst, driver_pins, i, RepairTarget::RepairMaxCapacitance,
+                clock_nets, options, solutions);
+        }
         auto pin_net = handler.net(pin);
         if (pin_net && !clock_nets.count(pin_net) &&
             !handler.isSpecial(pin_net))
@@ -555,13 +826,16 @@ RepairTimingTransform::fixCapacitanceViolations(
                 PSN_LOG_DEBUG("Fixing cap. violations for pin {}",
                               handler.name(pin));
                 repairPin(psn_inst, pin, RepairTarget::RepairMaxCapacitance,
-                          options);
+                          options, solutions[pin]);
                 if (options->legalization_frequency >
                     (getEditCount() - last_edit_count >=
                      options->legalization_frequency))
                 {
                     last_edit_count = buffer_count_;
                     handler.legalize();
+                    // Cell locations changed, rebuild the candidates
+                    solutions.clear();
+                    batch_end = i + 1;
                 }
 
                 if (handler.hasMaximumArea() &&
@@ -584,10 +858,20 @@ RepairTimingTransform::fixTransitionViolations(
     PSN_LOG_DEBUG("Fixing transition violations");
     DatabaseHandler& handler = *(psn_inst->handler());
     handler.resetDelays();
-    auto clock_nets      = handler.clockNets();
-    int  last_edit_count = getEditCount();
-    for (auto& pin : driver_pins)
+    auto   clock_nets      = handler.clockNets();
+    int    last_edit_count = getEditCount();
+    size_t batch_end       = 0;
+    std::unordered_map<InstanceTerm*, std::shared_ptr<BufferSolution>>
+        solutions;
+    for (size_t i = 0; i < driver_pins.size(); i++)
     {
+        auto pin = driver_pins[i];
+        if (options->parallel_threads > 1 && i == batch_end)
+        {
+            batch_end = buildBufferSolutions(psn_inst, driver_pins, i,
+                                             RepairTarget::RepairMaxTransition,
+                                             clock_nets, options, solutions);
+        }
         auto pin_net = handler.net(pin);
 
         if (pin_net && !clock_nets.count(pin_net) &&
@@ -601,8 +885,9 @@ RepairTimingTransform::fixTransitionViolations(
             {
                 PSN_LOG_DEBUG("Fixing transition violations for pin {}",
                               handler.name(pin));
-                auto added_buffers = repairPin(
-                    psn_inst, pin, RepairTarget::RepairMaxTransition, options);
+                auto added_buffers =
+                    repairPin(psn_inst, pin, RepairTarget::RepairMaxTransition,
+                              options, solutions[pin]);
 
                 if (options->legalization_frequency > 0 &&
                     (getEditCount() - last_edit_count >=
@@ -610,6 +895,9 @@ RepairTimingTransform::fixTransitionViolations(
                 {
                     last_edit_count = getEditCount();
                     handler.legalize();
+                    // Cell locations changed, rebuild the candidates
+                    solutions.clear();
+                    batch_end = i + 1;
                 }
                 if (handler.hasMaximumArea() &&
                     current_area_ > handler.maximumArea())
@@ -630,10 +918,20 @@ RepairTimingTransform::fixFanoutViolations(
     PSN_LOG_DEBUG("Fixing fanout violations");
     DatabaseHandler& handler = *(psn_inst->handler());
     handler.resetDelays();
-    auto clock_nets      = handler.clockNets();
-    int  last_edit_count = getEditCount();
-    for (auto& pin : driver_pins)
+    auto   clock_nets      = handler.clockNets();
+    int    last_edit_count = getEditCount();
+    size_t batch_end       = 0;
+    std::unordered_map<InstanceTerm*, std::shared_ptr<BufferSolution>>
+        solutions;
+    for (size_t i = 0; i < driver_pins.size(); i++)
     {
+        auto pin = driver_pins[i];
+        if (options->parallel_threads > 1 && i == batch_end)
+        {
+            batch_end = buildBufferSolutions(psn_inst, driver_pins, i,
+                                             RepairTarget::RepairMaxFanout,
+                                             clock_nets, options, solutions);
+        }
         auto pin_net = handler.net(pin);
 
         if (pin_net && !clock_nets.count(pin_net) &&
@@ -644,8 +942,9 @@ RepairTimingTransform::fixFanoutViolations(
             {
                 PSN_LOG_DEBUG("Fixing fanout violations for pin {}",
                               handler.name(pin));
-                auto added_buffers = repairPin(
-                    psn_inst, pin, RepairTarget::RepairMaxFanout, options);
+                auto added_buffers =
+                    repairPin(psn_inst, pin, RepairTarget::RepairMaxFanout,
+                              options, solutions[pin]);
 
                 if (options->legalization_frequency > 0 &&
                     (getEditCount() - last_edit_count >=
@@ -653,6 +952,9 @@ RepairTimingTransform::fixFanoutViolations(
                 {
                     last_edit_count = getEditCount();
                     handler.legalize();
+                    // Cell locations changed, rebuild the candidates
+                    solutions.clear();
+                    batch_end = i + 1;
                 }
                 if (handler.hasMaximumArea() &&
                     current_area_ > handler.maximumArea())
@@ -798,8 +1100,7 @@ void
 RepairTimingTransform::resizeDown(Psn* psn_inst, InstanceTerm* pin,
                                   std::unique_ptr<OptimizationOptions>& options)
 {
-    DatabaseHandler& handler  = *(psn_inst->handler());
-    auto             net_pins = handler.pins(handler.net(pin));
+    DatabaseHandler& handler = *(psn_inst->handler());
     handler.sta()->ensureLevelized();
     handler.sta()->vertexRequired(handler.vertex(pin), sta::MinMax::min());
     handler.sta()->findDelays(handler.vertex(pin));
@@ -826,7 +1127,7 @@ RepairTimingTransform::resizeDown(Psn* psn_inst, InstanceTerm* pin,
                 auto area = handler.area(d_type);
                 std::sort(options->buffer_lib.begin(),
                           options->buffer_lib.end(),
-                          [handler](LibraryCell* a, LibraryCell* b) -> bool {
+                          [&handler](LibraryCell* a, LibraryCell* b) -> bool {
                               return handler.area(a) > handler.area(b);
                           });
                 if (area < current_area &&
@@ -989,6 +1290,19 @@ RepairTimingTransform::repairTiming(
                  options->repair_by_pinswap ? "enabled" : "disabled");
     PSN_LOG_INFO("Mode: {}",
                  options->timerless ? "Timerless" : "Timing-Driven");
+    PSN_LOG_INFO("Threads: {}", options->parallel_threads);
+    if (options->max_candidates)
+    {
+        PSN_LOG_INFO("Maximum candidates: {} (grid {}s, {}F)",
+                     options->max_candidates, options->candidate_required_grid,
+                     options->candidate_capacitance_grid);
+    }
+#ifdef TF_ENABLED
+    if (options->parallel_threads > 1)
+    {
+        executor_ = std::make_shared<tf::Executor>(options->parallel_threads);
+    }
+#endif
 
     for (int i = 0; i < options->max_iterations; i++)
     {
@@ -1010,8 +1324,7 @@ RepairTimingTransform::repairTiming(
             if (options->legalization_frequency > 0)
             {
                 handler.legalize(1);
-                handler.setWireRC(handler.resistancePerMicron(),
-                                  handler.capacitancePerMicron(), false);
+                handler.updateParasitics();
             }
             driver_pins = handler.levelDriverPins(true, pins);
         }
@@ -1029,8 +1342,7 @@ RepairTimingTransform::repairTiming(
             if (options->legalization_frequency > 0)
             {
                 handler.legalize(1);
-                handler.setWireRC(handler.resistancePerMicron(),
-                                  handler.capacitancePerMicron(), false);
+                handler.updateParasitics();
             }
             driver_pins = handler.levelDriverPins(true, pins);
         }
@@ -1047,8 +1359,7 @@ RepairTimingTransform::repairTiming(
             if (options->legalization_frequency > 0)
             {
                 handler.legalize(1);
-                handler.setWireRC(handler.resistancePerMicron(),
-                                  handler.capacitancePerMicron(), false);
+                handler.updateParasitics();
             }
             driver_pins = handler.levelDriverPins(true, pins);
         }
@@ -1065,18 +1376,15 @@ RepairTimingTransform::repairTiming(
             if (options->legalization_frequency > 0)
             {
                 handler.legalize(1);
-                handler.setWireRC(handler.resistancePerMicron(),
-                                  handler.capacitancePerMicron(), false);
+                handler.updateParasitics();
             }
             driver_pins = handler.levelDriverPins(true, pins);
         }
-        handler.setWireRC(handler.resistancePerMicron(),
-                          handler.capacitancePerMicron(), false);
+        handler.updateParasitics();
         if (options->legalize_each_iteration)
         {
             handler.legalize(1);
-            handler.setWireRC(handler.resistancePerMicron(),
-                              handler.capacitancePerMicron(), false);
+            handler.updateParasitics();
         }
         handler.resetDelays();
         if (!hasVio)
@@ -1097,16 +1405,17 @@ RepairTimingTransform::repairTiming(
         if (options->legalization_frequency > 0)
         {
             handler.legalize(1);
-            handler.setWireRC(handler.resistancePerMicron(),
-                              handler.capacitancePerMicron(), false);
+            handler.updateParasitics();
         }
     }
     if (options->legalize_eventually)
     {
         handler.legalize(1);
-        handler.setWireRC(handler.resistancePerMicron(),
-                          handler.capacitancePerMicron(), false);
+        handler.updateParasitics();
     }
+#ifdef TF_ENABLED
+    executor_ = nullptr;
+#endif
     auto end      = std::chrono::high_resolution_clock::now();
     auto runtime  = end - start;
     current_area_ = handler.area();
@@ -1122,6 +1431,24 @@ RepairTimingTransform::repairTiming(
     PSN_LOG_INFO("Transition violations: {}", transition_violations_);
     PSN_LOG_INFO("Capacitance violations: {}", capacitance_violations_);
     PSN_LOG_INFO("Slack gain: {}", saved_slack_);
+    PSN_LOG_INFO("Skipped unchanged nets: {}", memoized_repairs_);
+    if (options->max_candidates)
+    {
+        PSN_LOG_INFO("Bounded Steiner points: {}", bound_stats_.bounded_points);
+        PSN_LOG_INFO("Dropped candidates: {} of {}",
+                     bound_stats_.dropped_candidates,
+                     bound_stats_.evaluated_candidates);
+        PSN_LOG_INFO("Maximum grid required time loss: {}",
+                     bound_stats_.max_required_loss);
+    }
+    auto steiner_stats = SteinerTree::statistics();
+    PSN_LOG_INFO("Steiner trees: {} Flute, {} spanning tree",
+                 steiner_stats.flute_nets, steiner_stats.spanning_tree_nets);
+    if (steiner_stats.spanning_tree_nets)
+    {
+        PSN_LOG_INFO("Maximum spanning tree degree: {}",
+                     steiner_stats.max_spanning_tree_degree);
+    }
     PSN_LOG_INFO("Initial area: {}",
                  handler.unitScaledArea(options->initial_area));
     PSN_LOG_INFO("New area: {}", handler.unitScaledArea(current_area_));
@@ -1139,6 +1466,10 @@ RepairTimingTransform::run(Psn* psn_inst, std::vector<std::string> args)
     pin_swap_count_    = 0;
     current_area_      = psn_inst->handler()->area();
     saved_slack_       = 0.0;
+    bound_stats_       = CandidateBoundStats();
+    memoized_repairs_  = 0;
+    SteinerTree::resetStatistics();
+    unchanged_nets_.clear();
     capacitance_violations_ =
         psn_inst->handler()->maximumCapacitanceViolations().size();
     transition_violations_ =
@@ -1192,6 +1523,15 @@ RepairTimingTransform::run(Psn* psn_inst, std::vector<std::string> args)
          "-transition_pessimism_factor",  // Transition limit scaling factor
          "-high_effort", // Trade-off runtime versus optimization quality by
                          // weaker pruning
+         "-threads",     // Number of threads used to build buffer trees
+         "-parallel_batch_size", // Maximum nets per parallel batch
+         "-max_candidates", // Maximum buffer candidates per Steiner point
+         "-candidate_required_grid",    // Required time grid of bounded
+                                        // candidate sets
+         "-candidate_capacitance_grid", // Capacitance grid of bounded
+                                        // candidate sets
+         "-squeeze_candidates", // Keep only the convex hull of merged
+                                // candidates
          "-upstream_resistance"}); // Override default minimum upstream
                                    // resistance
     for (size_t i = 0; i < args.size(); i++)
@@ -1508,12 +1848,94 @@ RepairTimingTransform::run(Psn* psn_inst, std::vector<std::string> args)
         {
             high_effort = true;
         }
+        else if (args[i] == "-squeeze_candidates")
+        {
+            options->squeeze_candidates = true;
+        }
+        else if (args[i] == "-threads")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atoi(args[i].c_str()) < 1)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->parallel_threads = atoi(args[i].c_str());
+            }
+        }
+        else if (args[i] == "-parallel_batch_size")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atoi(args[i].c_str()) < 1)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->parallel_batch_size = atoi(args[i].c_str());
+            }
+        }
+        else if (args[i] == "-max_candidates")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atoi(args[i].c_str()) < 0)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->max_candidates = atoi(args[i].c_str());
+            }
+        }
+        else if (args[i] == "-candidate_required_grid")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atof(args[i].c_str()) < 0)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->candidate_required_grid = atof(args[i].c_str());
+            }
+        }
+        else if (args[i] == "-candidate_capacitance_grid")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atof(args[i].c_str()) < 0)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->candidate_capacitance_grid = atof(args[i].c_str());
+            }
+        }
         else
         {
             PSN_LOG_ERROR(help());
             return -1;
         }
     }
+#ifndef TF_ENABLED
+    if (options->parallel_threads > 1)
+    {
+        PSN_LOG_WARN("OpenPhySyn is built without cpp-taskflow, running "
+                     "with a single thread");
+        options->parallel_threads = 1;
+    }
+#endif
     if (!custom_upstream_res)
     {
         if (high_effort)
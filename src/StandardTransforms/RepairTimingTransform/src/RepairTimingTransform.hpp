@@ -31,6 +31,8 @@
 
 #include <cstring>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include "OpenPhySyn/Database/Types.hpp"
 #include "OpenPhySyn/Liberty/LibraryMapping.hpp"
@@ -39,6 +41,13 @@
 #include "OpenPhySyn/Psn/Psn.hpp"
 #include "OpenPhySyn/Transform/PsnTransform.hpp"
 
+#ifdef TF_ENABLED
+namespace tf
+{
+class Executor;
+} // namespace tf
+#endif
+
 namespace psn
 {
 
@@ -64,11 +73,47 @@ private:
                                  // violations
     float current_area_;         // Incremental area holder
     float saved_slack_;          // Total slack gain
-
-    // Repair a single pin
+    CandidateBoundStats bound_stats_; // Bounded candidate pruning summary
+    int memoized_repairs_; // Number of repair attempts skipped on unchanged
+                           // nets
+    std::unordered_map<Net*, size_t>
+        unchanged_nets_; // Fingerprints of the nets whose last repair attempt
+                         // made no edits
+#ifdef TF_ENABLED
+    std::shared_ptr<tf::Executor> executor_; // Worker pool for parallel
+                                             // candidate generation
+#endif
+
+    // Repair a single pin, buff_sol is used instead of running the bottom-up
+    // candidate generation if provided. Nets that are unchanged since an
+    // attempt that made no edits are skipped.
     std::unordered_set<Instance*>
     repairPin(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
-              std::unique_ptr<OptimizationOptions>& options);
+              std::unique_ptr<OptimizationOptions>& options,
+              std::shared_ptr<BufferSolution>       buff_sol = nullptr);
+    std::unordered_set<Instance*>
+    repairPinUncached(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+                      std::unique_ptr<OptimizationOptions>& options,
+                      std::shared_ptr<BufferSolution>       buff_sol);
+
+    // Hash of the driver cell, sink pins, pin locations, quantized required
+    // times, wire RC and buffer library of the pin's net
+    size_t netFingerprint(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+                          std::unique_ptr<OptimizationOptions>& options);
+    // True if the pin's net is unchanged since a repair attempt that made
+    // no edits
+    bool isMemoized(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+                    std::unique_ptr<OptimizationOptions>& options);
+
+    // Build the candidate buffer trees for the next batch of independent
+    // violating pins starting at driver_pins[start] on the worker pool,
+    // returns the index following the batch
+    size_t buildBufferSolutions(
+        Psn* psn_inst, std::vector<InstanceTerm*>& driver_pins, size_t start,
+        RepairTarget target, std::set<Net*>& clock_nets,
+        std::unique_ptr<OptimizationOptions>& options,
+        std::unordered_map<InstanceTerm*, std::shared_ptr<BufferSolution>>&
+            solutions);
 
     // Number of applied design edit
     int getEditCount() const;
@@ -133,7 +178,10 @@ public:
         "[-high_effort] [-capacitance_pessimism_factor factor] "
         "[-transition_pessimism_factor factor] [-pins <pin names>] "
         "[-maximum_negative_slack_paths count] "
-        "[-maximum_negative_slack_path_depth count]")
+        "[-maximum_negative_slack_path_depth count] [-threads count] "
+        "[-parallel_batch_size count] [-max_candidates count] "
+        "[-candidate_required_grid time] "
+        "[-candidate_capacitance_grid capacitance] [-squeeze_candidates]")
 };
 
 } // namespace psn
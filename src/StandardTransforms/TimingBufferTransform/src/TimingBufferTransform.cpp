@@ -102,7 +102,7 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
         handler.ripupBuffers(fanout_buff);
     }
     pin_net      = handler.net(pin);
-    auto st_tree = SteinerTree::create(pin_net, psn_inst);
+    auto st_tree = handler.steinerTree(pin_net);
     if (!st_tree)
     {
         PSN_LOG_DEBUG("Failed to create steiner tree for {}",
@@ -138,10 +138,10 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
     }
     std::unordered_set<Instance*> added_buffers;
     std::unordered_set<Net*>      affected_nets;
-    if (buff_sol->bufferTrees().size())
+    if (buff_sol->trees().size())
     {
         std::shared_ptr<BufferTree> buff_tree    = nullptr;
-        auto                        no_buff_tree = buff_sol->bufferTrees()[0];
+        auto                        no_buff_tree = buff_sol->bufferTree(0);
         auto driver_lib = handler.libraryCell(driver_cell);
         if (options->driver_resize && driver_cell &&
             handler.outputPins(driver_cell).size() == 1)
@@ -266,11 +266,11 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
                 float buff_tree_slack =
                     buff_tree->totalRequiredOrSlew() - buff_tree_delay;
 
-                for (size_t i = 1; i < buff_sol->bufferTrees().size() &&
+                for (size_t i = 1; i < buff_sol->trees().size() &&
                                    i < options->best_solution_threshold_range;
                      i++)
                 {
-                    auto& tr = buff_sol->bufferTrees()[i];
+                    auto  tr = buff_sol->bufferTree(i);
                     float tr_delay =
                         handler.gateDelay(pin, tr->totalCapacitance());
                     float tr_slack = tr->totalRequiredOrSlew() - tr_delay;
@@ -482,8 +482,7 @@ TimingBufferTransform::fixTransitionViolations(
 
         if (pin_net && !clock_nets.count(pin_net))
         {
-            auto net_pins = handler.pins(pin_net);
-            auto vio      = handler.hasElectricalViolation(pin);
+            auto vio = handler.hasElectricalViolation(pin);
             if (vio == ElectircalViolation::Transition ||
                 vio == ElectircalViolation::CapacitanceAndTransition)
             {
@@ -365,6 +365,9 @@ namespace eval psn {
         [-legalize_each_iteration] [-post_place] [-post_route] [-pins pin_names] [-no_resize_for_negative_slack]\
         [-legalization_frequency num_edits] [-high_effort] [-capacitance_pessimism_factor factor] [-transition_pessimism_factor factor]\
         [-upstream_resistance res] [-maximum_negative_slack_paths count] [-maximum_negative_slack_path_depth count]\
+        [-threads count] [-parallel_batch_size count] [-max_candidates count]\
+        [-candidate_required_grid time] [-candidate_capacitance_grid capacitance]\
+        [-squeeze_candidates]\
     }
     proc repair_timing { args } {
         if {![psn::has_liberty]} {
@@ -0,0 +1,231 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Optimize/BufferTree.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "doctest.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+
+namespace psn
+{
+typedef std::tuple<float, float, float> Candidate; // (cap, req, cost)
+
+static std::shared_ptr<BufferSolution>
+makeSolution(BufferMode mode, std::shared_ptr<BufferTreeArena>& arena,
+             const std::vector<Candidate>& candidates, int polarity = 0)
+{
+    auto solution = std::make_shared<BufferSolution>(mode, arena);
+    for (auto& cand : candidates)
+    {
+        solution->addTree(arena->create<BufferTree>(
+            std::get<0>(cand), std::get<1>(cand), std::get<2>(cand),
+            Point(0, 0), nullptr, nullptr, nullptr, polarity, mode));
+    }
+    return solution;
+}
+
+static std::vector<Candidate>
+sortedCandidates(BufferSolution& solution)
+{
+    std::vector<Candidate> candidates;
+    for (auto& tree : solution.trees())
+    {
+        candidates.push_back(Candidate(tree->totalCapacitance(),
+                                       tree->totalRequiredOrSlew(),
+                                       tree->cost()));
+    }
+    std::sort(candidates.begin(), candidates.end());
+    return candidates;
+}
+
+static void
+checkCandidates(const std::vector<Candidate>& actual,
+                const std::vector<Candidate>& expected)
+{
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); i++)
+    {
+        auto& cand = expected[i];
+        CHECK(std::get<0>(actual[i]) == doctest::Approx(std::get<0>(cand)));
+        CHECK(std::get<1>(actual[i]) == doctest::Approx(std::get<1>(cand)));
+        CHECK(std::get<2>(actual[i]) == doctest::Approx(std::get<2>(cand)));
+    }
+}
+
+
+TEST_CASE("testing bounded buffer candidates")
+{
+    // Cheaper as the capacitance grows with the best required time in the
+    // middle, none of the candidates dominates another
+    auto arena = std::make_shared<BufferTreeArena>();
+    BufferSolution solution(BufferMode::TimingDriven, arena);
+    const int      candidate_count = 20;
+    const int      best_index      = 7;
+    for (int i = 0; i < candidate_count; i++)
+    {
+        float required = (10 - std::abs(i - best_index)) * 1.0E-11;
+        solution.addTree(arena->create<BufferTree>(i * 1.0E-15, required,
+                                                   candidate_count - i));
+    }
+    CandidateBoundStats stats;
+    solution.boundCandidates(4, 1.0E-12, 1.0E-15, stats);
+    auto& trees = solution.trees();
+    CHECK(trees.size() == 4);
+    CHECK(stats.evaluated_candidates == candidate_count);
+    CHECK(stats.dropped_candidates == candidate_count - 4);
+    CHECK(stats.bounded_points == 1);
+    CHECK(stats.max_required_loss == 0.0);
+
+    // The best required time and both capacitance ends are kept
+    auto best = std::max_element(trees.begin(), trees.end(),
+                                 [](BufferTree* a, BufferTree* b) -> bool {
+                                     return a->totalRequiredOrSlew() <
+                                            b->totalRequiredOrSlew();
+                                 });
+    CHECK((*best)->totalRequiredOrSlew() == doctest::Approx(10 * 1.0E-11));
+    CHECK((*best)->cost() == candidate_count - best_index);
+    CHECK(trees.front()->cost() == candidate_count);
+    CHECK(trees.back()->cost() == 1);
+}
+TEST_CASE("testing buffer branch merging")
+{
+    Psn& psn_inst = Psn::instance();
+    // (cap, slew or required, cost) of the left and right branches
+    std::vector<Candidate> left_candidates  = {Candidate(1, 2, 3),
+                                              Candidate(2, 4, 2),
+                                              Candidate(3, 6, 1),
+                                              Candidate(2, 5, 3)};
+    std::vector<Candidate> right_candidates = {
+        Candidate(1, 3, 2), Candidate(4, 1, 1), Candidate(2, 2.5, 3)};
+
+    SUBCASE("cost-driven")
+    {
+        // Timerless merging keeps the worst slew and prunes by increasing
+        // cost, so the result is the (cap, slew, cost) Pareto set of all the
+        // pairs. The (2, 5, 3) left branch only pairs into dominated
+        // candidates.
+        auto arena = std::make_shared<BufferTreeArena>();
+        auto left =
+            makeSolution(BufferMode::Timerless, arena, left_candidates);
+        auto right =
+            makeSolution(BufferMode::Timerless, arena, right_candidates);
+        // An inverted candidate without an inverted partner is not merged
+        left->addTree(arena->create<BufferTree>(
+            1, 1, 1, Point(0, 0), nullptr, nullptr, nullptr, 1,
+            BufferMode::Timerless));
+        BufferSolution merged(&psn_inst, left, right, Point(0, 0), nullptr,
+                              100, BufferMode::Timerless);
+        checkCandidates(sortedCandidates(merged),
+                        {Candidate(2, 3, 5), Candidate(3, 2.5, 6),
+                         Candidate(3, 4, 4), Candidate(4, 6, 3),
+                         Candidate(5, 2, 4), Candidate(6, 4, 3),
+                         Candidate(7, 6, 2)});
+    }
+    SUBCASE("timing-driven")
+    {
+        try
+        {
+            psn_inst.clearDatabase();
+            psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                             "NangateOpenCellLibrary_typical.lib");
+            psn_inst.readLef("../tests/data/libraries/Nangate45/"
+                             "NangateOpenCellLibrary.mod.lef");
+            psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+            auto& handler = *(psn_inst.handler());
+            auto  buffer  = handler.smallestBufferCell();
+            REQUIRE(buffer);
+
+            // Same branches with a higher required time being better, in
+            // fF and ns
+            auto arena = std::make_shared<BufferTreeArena>();
+            auto scale = [](std::vector<Candidate> candidates) {
+                for (auto& cand : candidates)
+                {
+                    cand = Candidate(std::get<0>(cand) * 1.0E-15,
+                                     (10 - std::get<1>(cand)) * 1.0E-9,
+                                     std::get<2>(cand));
+                }
+                return candidates;
+            };
+            auto left  = makeSolution(BufferMode::TimingDriven, arena,
+                                     scale(left_candidates));
+            auto right = makeSolution(BufferMode::TimingDriven, arena,
+                                      scale(right_candidates));
+
+            // Pareto set of all the pairs in (required through the
+            // upstream buffer, cap, cost)
+            std::vector<Candidate> pairs, expected;
+            for (auto& l : left->trees())
+            {
+                for (auto& r : right->trees())
+                {
+                    pairs.push_back(Candidate(
+                        l->totalCapacitance() + r->totalCapacitance(),
+                        std::min(l->totalRequiredOrSlew(),
+                                 r->totalRequiredOrSlew()),
+                        l->cost() + r->cost()));
+                }
+            }
+            auto buffered = [&](const Candidate& cand) -> float {
+                return std::get<1>(cand) -
+                       handler.bufferDelay(buffer, std::get<0>(cand));
+            };
+            for (auto& pair : pairs)
+            {
+                bool dominated = false;
+                for (auto& other : pairs)
+                {
+                    dominated |= other != pair &&
+                                 buffered(other) >= buffered(pair) &&
+                                 std::get<0>(other) <= std::get<0>(pair) &&
+                                 std::get<2>(other) <= std::get<2>(pair);
+                }
+                if (!dominated)
+                {
+                    expected.push_back(pair);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+
+            BufferSolution merged(&psn_inst, left, right, Point(0, 0), buffer,
+                                  0);
+            checkCandidates(sortedCandidates(merged), expected);
+        }
+        catch (PsnException& e)
+        {
+            FAIL(e.what());
+        }
+    }
+}
+} // namespace psn
@@ -61,3 +61,47 @@ TEST_CASE("testing repair_timing transform")
         FAIL(e.what());
     }
 }
+#ifdef TF_ENABLED
+// Buffers the same design serially and on the batch workers
+static int
+repairWithThreads(Psn& psn_inst, const char* threads, float& area,
+                  size_t& instance_count)
+{
+    psn_inst.clearDatabase();
+    psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                     "NangateOpenCellLibrary_typical.lib");
+    psn_inst.readLef(
+        "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+    psn_inst.readDef("../tests/data/designs/timing_buffer/ibex_resized.def");
+    psn_inst.setWireRC("metal2");
+    psn_inst.handler()->setMaximumFanout(50);
+    auto result = psn_inst.runTransform(
+        "repair_timing",
+        std::vector<std::string>({"-fanout_violations", "-threads", threads}));
+    area           = psn_inst.handler()->area();
+    instance_count = psn_inst.handler()->instances().size();
+    return result;
+}
+TEST_CASE("testing parallel repair_timing transform")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        float  serial_area, parallel_area;
+        size_t serial_instances, parallel_instances;
+        auto   serial =
+            repairWithThreads(psn_inst, "1", serial_area, serial_instances);
+        auto parallel = repairWithThreads(psn_inst, "2", parallel_area,
+                                          parallel_instances);
+        CHECK(serial > 0);
+        CHECK(parallel == serial);
+        CHECK(parallel_area == serial_area);
+        CHECK(parallel_instances == serial_instances);
+        CHECK(psn_inst.handler()->maximumFanoutViolations().size() == 0);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+#endif
\ No newline at end of file
@@ -28,14 +28,118 @@
 // CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Sta/DatabaseSta.hpp"
 #include "OpenPhySyn/Sta/PathPoint.hpp"
 #include "Psn/Psn.hpp"
 #include "PsnException/PsnException.hpp"
 #include "Utils/FileUtils.hpp"
 #include "doctest.h"
+#include "opendb/geom.h"
+#include "sta/ArcDelayCalc.hh"
+#include "sta/Corner.hh"
+#include "sta/DcalcAnalysisPt.hh"
+#include "sta/Liberty.hh"
+#include "sta/TimingArc.hh"
+
+#include <cstdio>
+#include <limits>
 
 namespace psn
 {
+// Loads the gcd design on the Nangate45 library
+static void
+loadGcd(Psn& psn_inst)
+{
+    psn_inst.clearDatabase();
+    psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                     "NangateOpenCellLibrary_typical.lib");
+    psn_inst.readLef(
+        "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+    psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+}
+
+// Worst delay and slew of the output port through the delay calculator,
+// bypassing the compiled tables
+static void
+calculatedDelayAndSlew(Psn& psn_inst, LibraryTerm* out_port, float in_slew,
+                       float load_cap, float& delay, float& slew)
+{
+    auto sta      = psn_inst.handler()->sta();
+    auto dcalc_ap = sta->findCorner("default")->findDcalcAnalysisPt(
+        sta::MinMax::max());
+    auto cell = out_port->libertyCell();
+    delay     = -std::numeric_limits<float>::max();
+    slew      = -std::numeric_limits<float>::max();
+    sta::LibertyCellTimingArcSetIterator set_iter(cell);
+    while (set_iter.hasNext())
+    {
+        sta::TimingArcSet* arc_set = set_iter.next();
+        if (arc_set->to() != out_port)
+        {
+            continue;
+        }
+        sta::TimingArcSetArcIterator arc_iter(arc_set);
+        while (arc_iter.hasNext())
+        {
+            sta::TimingArc* arc = arc_iter.next();
+            sta::ArcDelay   gate_delay;
+            sta::Slew       drvr_slew;
+            sta->arcDelayCalc()->gateDelay(
+                cell, arc, in_slew, load_cap, nullptr, 0.0,
+                dcalc_ap->operatingConditions(), dcalc_ap, gate_delay,
+                drvr_slew);
+            delay = std::max(delay, gate_delay);
+            slew  = std::max(slew, drvr_slew);
+        }
+    }
+}
+
+// Compiled buffer delays and slews against the delay calculator, and the
+// batch queries against the single point ones
+static void
+checkCompiledTables(Psn& psn_inst)
+{
+    auto& handler = *(psn_inst.handler());
+    auto  cells   = handler.bufferCells();
+    REQUIRE(!cells.empty());
+    for (auto& cell : cells)
+    {
+        auto               output_pin = handler.bufferOutputPin(cell);
+        std::vector<float> loads, input_slews;
+        for (int i = 0; i <= 10; i++)
+        {
+            for (int j = 0; j <= 4; j++)
+            {
+                loads.push_back(i * 5.0E-15);
+                input_slews.push_back(j * 50.0E-12);
+            }
+        }
+        for (size_t i = 0; i < loads.size(); i++)
+        {
+            float in_slew = input_slews[i];
+            float delay, slew;
+            calculatedDelayAndSlew(psn_inst, output_pin, in_slew, loads[i],
+                                   delay, slew);
+            CHECK(handler.gateDelay(output_pin, loads[i], &in_slew) ==
+                  doctest::Approx(delay).epsilon(1E-3));
+            CHECK(handler.slew(output_pin, loads[i], &in_slew) ==
+                  doctest::Approx(std::max(slew, 0.0f)).epsilon(1E-3));
+        }
+        std::vector<float> delays, slews;
+        handler.gateDelays(output_pin, loads, delays);
+        handler.slews(output_pin, loads, input_slews, slews);
+        REQUIRE(delays.size() == loads.size());
+        REQUIRE(slews.size() == loads.size());
+        for (size_t i = 0; i < loads.size(); i++)
+        {
+            float in_slew = input_slews[i];
+            CHECK(delays[i] ==
+                  doctest::Approx(handler.gateDelay(output_pin, loads[i])));
+            CHECK(slews[i] == doctest::Approx(handler.slew(
+                                  output_pin, loads[i], &in_slew)));
+        }
+    }
+}
 
 TEST_CASE("testing sta functions")
 {
@@ -68,4 +172,222 @@ TEST_CASE("testing sta functions")
         FAIL(e.what());
     }
 }
+TEST_CASE("testing buffer delay models")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        auto& handler = *(psn_inst.handler());
+        for (auto& cell : handler.bufferCells())
+        {
+            auto model = handler.bufferDelayModel(cell);
+            REQUIRE(model != nullptr);
+            auto output_pin = handler.bufferOutputPin(cell);
+            for (int i = 1; i <= 10; i++)
+            {
+                float load = model->maxLoad() * i / 10.0;
+                CHECK(model->delay(load) ==
+                      doctest::Approx(handler.gateDelay(output_pin, load))
+                          .epsilon(0.02));
+            }
+        }
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing compiled delay tables")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        checkCompiledTables(psn_inst);
+
+        // Its templates list the load axis first
+        psn_inst.clearDatabase();
+        psn_inst.readLib("../tests/data/libraries/gscl45nm/gscl45nm.lib");
+        checkCompiledTables(psn_inst);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing connectivity snapshot")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        auto& handler = *(psn_inst.handler());
+        auto  nets    = handler.nets();
+        std::vector<std::vector<InstanceTerm*>> fanouts;
+        std::vector<InstanceTerm*>              drivers;
+        for (auto& net : nets)
+        {
+            fanouts.push_back(handler.fanoutPins(net, true));
+            drivers.push_back(handler.faninPin(net));
+        }
+        handler.buildConnectivity();
+        REQUIRE(handler.connectivity() != nullptr);
+        for (size_t i = 0; i < nets.size(); i++)
+        {
+            CHECK(handler.fanoutPins(nets[i], true) == fanouts[i]);
+            CHECK(handler.faninPin(nets[i]) == drivers[i]);
+        }
+        Net* net = nullptr;
+        for (size_t i = 0; i < nets.size() && !net; i++)
+        {
+            net = drivers[i] ? nets[i] : nullptr;
+        }
+        auto buffer = handler.smallestBufferCell();
+        if (net && buffer)
+        {
+            auto fanout  = handler.fanoutPins(net);
+            auto buf_net = handler.bufferNet(net, buffer, "snapshot_buf",
+                                             "snapshot_net", Point(0, 0));
+            CHECK(handler.fanoutPins(net).size() == fanout.size() + 1);
+            CHECK(handler.faninPin(buf_net) ==
+                  handler.outputPins(handler.instance("snapshot_buf"))[0]);
+            CHECK(handler.disconnectAll(buf_net) > 0);
+            CHECK(handler.pins(buf_net).empty());
+            CHECK(handler.faninPin(buf_net) == nullptr);
+        }
+        handler.clearConnectivity();
+        CHECK(handler.connectivity() == nullptr);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing compiled cell functions")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        auto& handler = *(psn_inst.handler());
+        for (auto& inst : handler.instances())
+        {
+            if (!handler.isSingleOutputCombinational(inst))
+            {
+                continue;
+            }
+            auto cell       = handler.libraryCell(inst);
+            auto output_pin = handler.libraryOutputPins(cell)[0];
+            auto input_pins = handler.libraryInputPins(cell);
+            for (int m = 0; m < (1 << input_pins.size()); m++)
+            {
+                std::unordered_map<LibraryTerm*, int> sim_vals;
+                for (size_t i = 0; i < input_pins.size(); i++)
+                {
+                    sim_vals[input_pins[i]] = (m >> i) & 1;
+                }
+                CHECK(handler.evaluateFunctionExpression(output_pin,
+                                                         sim_vals) ==
+                      handler.evaluateFunctionExpression(
+                          output_pin->function(), sim_vals));
+            }
+        }
+        auto nand_a1 = handler.libraryPin("NAND2_X1", "A1");
+        auto nand_a2 = handler.libraryPin("NAND2_X1", "A2");
+        CHECK(handler.isCommutative(nand_a1, nand_a2));
+        auto aoi_a  = handler.libraryPin("AOI21_X1", "A");
+        auto aoi_b1 = handler.libraryPin("AOI21_X1", "B1");
+        auto aoi_b2 = handler.libraryPin("AOI21_X1", "B2");
+        CHECK(handler.isCommutative(aoi_b1, aoi_b2));
+        CHECK(!handler.isCommutative(aoi_a, aoi_b1));
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing library characterization cache")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        auto&       handler    = *(psn_inst.handler());
+        std::string cache_path = "characterization_cache_test.bin";
+        std::remove(cache_path.c_str());
+        handler.setCharacterizationCache(cache_path);
+        handler.resetCache();
+        auto  buffer   = handler.bufferCells()[0];
+        float load_cap = 4 * handler.targetLoad(buffer);
+        float penalty  = handler.bufferChainDelayPenalty(load_cap);
+        float delay    = handler.bufferDelayModel(buffer)->delay(load_cap);
+        auto  clusters = handler.bufferClusters(0.25);
+        handler.buildLibraryMappings(4);
+        auto table = handler.cellToTruthTable(buffer);
+        // Written once, when the results are saved
+        CHECK(!FileUtils::pathExists(cache_path));
+        handler.saveCharacterizationCache();
+        CHECK(FileUtils::pathExists(cache_path));
+
+        // A new cache session reads the results back from the file
+        handler.resetCache();
+        handler.setCharacterizationCache(cache_path);
+        CHECK(handler.targetLoad(buffer) == doctest::Approx(load_cap / 4));
+        CHECK(handler.bufferDelayModel(buffer)->delay(load_cap) == delay);
+        CHECK(handler.bufferChainDelayPenalty(load_cap) == penalty);
+        CHECK(handler.bufferClusters(0.25) == clusters);
+        handler.buildLibraryMappings(4);
+        CHECK(handler.cellToTruthTable(buffer) == table);
+        handler.setCharacterizationCache("");
+        std::remove(cache_path.c_str());
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing incremental parasitics")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        loadGcd(psn_inst);
+        auto& handler = *(psn_inst.handler());
+        psn_inst.setWireRC(0.0020, 0.00020);
+        InstanceTerm*              driver = nullptr;
+        std::vector<InstanceTerm*> fanout;
+        for (auto& net : handler.nets())
+        {
+            auto net_driver = handler.faninPin(net);
+            if (!net_driver || handler.isClock(net))
+            {
+                continue;
+            }
+            float pins_cap = 0.0;
+            for (auto& pin : handler.fanoutPins(net))
+            {
+                pins_cap += handler.pinCapacitance(pin);
+            }
+            // Wired net, the load includes the Steiner tree capacitance
+            if (handler.loadCapacitance(net_driver) > pins_cap)
+            {
+                driver = net_driver;
+                fanout = handler.fanoutPins(net);
+                break;
+            }
+        }
+        REQUIRE(driver != nullptr);
+        for (auto& pin : fanout)
+        {
+            handler.disconnect(pin);
+        }
+        handler.updateParasitics();
+        CHECK(handler.loadCapacitance(driver) == doctest::Approx(0.0));
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
 } // namespace psn
\ No newline at end of file
@@ -61,4 +61,193 @@ TEST_CASE("testing steiner tree construction")
         FAIL(e.what());
     }
 }
+TEST_CASE("testing steiner tree wire timing")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/fanout/fanout_nan.def");
+        auto& handler        = *(psn_inst.handler());
+        auto  net            = handler.net("clk");
+        auto  tree           = SteinerTree::create(net, &psn_inst, 3);
+        float cap_per_micron = 1.0E-10;
+        auto  timing         = tree->wireTiming(1.0E+6, cap_per_micron);
+        CHECK((int)timing.sinks.size() ==
+              tree->subtreeSinkCount(tree->driverPoint()));
+        CHECK(timing.driver_load ==
+              doctest::Approx(tree->totalLoad(cap_per_micron)));
+        for (size_t i = 0; i < timing.sinks.size(); i++)
+        {
+            CHECK(timing.sink_delays[i] >= 0.0);
+            CHECK(timing.sinkSlew(i, 0.0) ==
+                  doctest::Approx(timing.sink_slews[i]));
+        }
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing batch steiner tree construction")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                         "NangateOpenCellLibrary_typical.lib");
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+        auto& handler = *(psn_inst.handler());
+        auto  nets    = handler.nets();
+        auto  trees   = SteinerTree::createMany(nets, &psn_inst, 3, 4);
+        REQUIRE(trees.size() == nets.size());
+        for (size_t i = 0; i < nets.size(); i++)
+        {
+            auto tree = SteinerTree::create(nets[i], &psn_inst, 3);
+            REQUIRE((tree == nullptr) == (trees[i] == nullptr));
+            if (!tree)
+            {
+                continue;
+            }
+            CHECK(trees[i]->net() == tree->net());
+            CHECK(trees[i]->method() == tree->method());
+            CHECK(trees[i]->driverPoint() == tree->driverPoint());
+            REQUIRE(trees[i]->branchCount() == tree->branchCount());
+            for (int j = 0; j < tree->branchCount(); j++)
+            {
+                auto batch_branch = trees[i]->branch(j);
+                auto branch       = tree->branch(j);
+                CHECK(batch_branch.firstPoint().x() == branch.firstPoint().x());
+                CHECK(batch_branch.firstPoint().y() == branch.firstPoint().y());
+                CHECK(batch_branch.secondPoint().x() ==
+                      branch.secondPoint().x());
+                CHECK(batch_branch.secondPoint().y() ==
+                      branch.secondPoint().y());
+                CHECK(batch_branch.firstPin() == branch.firstPin());
+                CHECK(batch_branch.secondPin() == branch.secondPin());
+            }
+            CHECK(trees[i]->wirelength() == tree->wirelength());
+        }
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing spanning tree steiner heuristic")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/fanout/fanout_nan.def");
+        auto& handler     = *(psn_inst.handler());
+        auto  net         = handler.net("clk");
+        auto  flute_tree  = SteinerTree::create(net, &psn_inst, 3);
+        int   flute_limit = handler.steinerFluteDegreeLimit();
+        handler.setSteinerFluteDegreeLimit(4);
+        auto tree = SteinerTree::create(net, &psn_inst, 3);
+        handler.setSteinerFluteDegreeLimit(flute_limit);
+        REQUIRE(tree != nullptr);
+        CHECK(flute_tree->method() == SteinerMethod::Flute);
+        CHECK(tree->method() == SteinerMethod::SpanningTree);
+
+        // Pins are the first points, the driver has only the top point below
+        // it and every other pin is a leaf
+        int degree = tree->pinCount();
+        REQUIRE(degree > 4);
+        CHECK(tree->branchCount() == 2 * degree - 2);
+        SteinerPoint driver = tree->driverPoint();
+        REQUIRE(driver != SteinerNull);
+        for (int pt = 0; pt < degree; pt++)
+        {
+            CHECK(tree->pin(pt) != nullptr);
+            if (pt != driver)
+            {
+                CHECK(tree->isLeaf(pt));
+            }
+        }
+        CHECK(tree->top() != SteinerNull);
+        CHECK((tree->left(driver) == SteinerNull) !=
+              (tree->right(driver) == SteinerNull));
+
+        // Every point is reached from the driver exactly once
+        std::vector<int>          visits(tree->branchCount(), 0);
+        std::vector<SteinerPoint> stack(1, driver);
+        while (!stack.empty())
+        {
+            SteinerPoint pt = stack.back();
+            stack.pop_back();
+            visits[pt]++;
+            for (auto next : {tree->left(pt), tree->right(pt)})
+            {
+                if (next != SteinerNull)
+                {
+                    stack.push_back(next);
+                }
+            }
+        }
+        for (auto& count : visits)
+        {
+            CHECK(count == 1);
+        }
+
+        // Starts from a minimum spanning tree, which is at most 3/2 of the
+        // rectilinear Steiner minimal tree
+        CHECK(tree->wirelength() > 0.0);
+        CHECK(tree->wirelength() <= 1.5 * flute_tree->wirelength());
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+TEST_CASE("testing steiner tree statistics")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/fanout/fanout_nan.def");
+        auto& handler     = *(psn_inst.handler());
+        auto  net         = handler.net("clk");
+        int   flute_limit = handler.steinerFluteDegreeLimit();
+        SteinerTree::resetStatistics();
+        auto tree   = SteinerTree::create(net, &psn_inst, 3);
+        auto stats  = SteinerTree::statistics();
+        int  degree = tree->pinCount();
+        CHECK(stats.flute_nets == 1);
+        CHECK(stats.spanning_tree_nets == 0);
+
+        // The same net above the limit moves to the spanning tree counters
+        handler.setSteinerFluteDegreeLimit(degree - 1);
+        SteinerTree::create(net, &psn_inst, 3);
+        handler.setSteinerFluteDegreeLimit(degree);
+        SteinerTree::create(net, &psn_inst, 3);
+        handler.setSteinerFluteDegreeLimit(flute_limit);
+        stats = SteinerTree::statistics();
+        CHECK(stats.flute_nets == 2);
+        CHECK(stats.spanning_tree_nets == 1);
+        CHECK(stats.max_spanning_tree_degree == (size_t)degree);
+
+        SteinerTree::resetStatistics();
+        stats = SteinerTree::statistics();
+        CHECK(stats.flute_nets == 0);
+        CHECK(stats.spanning_tree_nets == 0);
+        CHECK(stats.max_spanning_tree_degree == 0);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
 } // namespace psn
\ No newline at end of file